@@ -19,11 +19,18 @@
 #include <map>
 #include <queue>
 
+#include "../../common/fast_reader.h"
+#include "../../common/fast_writer.h"
+#include "../../common/instance_cache.h"
+#include "../../common/run_control.h"
+
 using namespace std;
 
 typedef pair<int, int> pi;
 typedef vector<int> vi;
 
+double time_limit = 0; // wall-clock budget in seconds, 0 = none
+
 class car{
 public:
   int id; // car id
@@ -50,17 +57,38 @@ public:
   int N, M, T, C, S; // number of nodes, streets, time limit, number of cars and start ID of all cars
 
   // read file accordding to problem definition
-  void read(){
-    cin >> N >> M >> T >> C >> S;
-    cars.resize(C);
-    for (int i = 0; i < C; i++){ cars[i].id = i; cars[i].moves = {4516};}
+  void read(fast_reader &in){
+    in >> N >> M >> T >> C >> S;
     cities.resize(N);
-    for (int i = 0; i < N; i++) cin >> cities[i].first >> cities[i].second;
+    for (int i = 0; i < N; i++) in >> cities[i].first >> cities[i].second;
     edges.resize(M);
-    neighbors.resize(N);
     for (int i = 0; i < M; i++){
       edges[i].id = i;
-      cin >> edges[i].node_ids.first >> edges[i].node_ids.second >> edges[i].one_directional >> edges[i].time >> edges[i].length;
+      in >> edges[i].node_ids.first >> edges[i].node_ids.second >> edges[i].one_directional >> edges[i].time >> edges[i].length;
+    }
+    init();
+  }
+
+  // instance cache: only the parsed arrays are stored, the rest is rebuilt by init
+  void save(cache_writer &snapshot){
+    snapshot.put(N); snapshot.put(M); snapshot.put(T); snapshot.put(C); snapshot.put(S);
+    snapshot.put(cities);
+    snapshot.put(edges);
+  }
+
+  void load(cache_reader &snapshot){
+    N = snapshot.get<int>(); M = snapshot.get<int>(); T = snapshot.get<int>(); C = snapshot.get<int>(); S = snapshot.get<int>();
+    snapshot.get(cities);
+    snapshot.get(edges);
+    init();
+  }
+
+  // sets up cars, neighbors and edge ids from the parsed cities and edges
+  void init(){
+    cars.resize(C);
+    for (int i = 0; i < C; i++){ cars[i].id = i; cars[i].moves = {4516};}
+    neighbors.resize(N);
+    for (int i = 0; i < M; i++){
       neighbors[edges[i].node_ids.first].push_back(edges[i].node_ids.second);
       if (edges[i].one_directional == 2){
         neighbors[edges[i].node_ids.second].push_back(edges[i].node_ids.first);
@@ -71,11 +99,11 @@ public:
   }
 
   // write out answer in specified format
-  void write(){
-    cout << C << endl;
+  void write(fast_writer &os){
+    os << C << '\n';
     for (int i = 0; i < C; i++){
-      cout << cars[i].moves.size() << endl;
-      for (int m: cars[i].moves) cout << m << endl;
+      os << cars[i].moves.size() << '\n';
+      for (int m: cars[i].moves) os << m << '\n';
     }
   }
 
@@ -89,6 +117,7 @@ public:
 
     // start bfs
     while (!path_candidates.empty()){
+      if (run_control::stopped()) break; // out of time: the best path so far is still valid
       // retrieve current node
       tuple<vi, double, double> p = path_candidates.front(); path_candidates.pop();
       vi current_path = get<0>(p);
@@ -151,6 +180,7 @@ public:
       pi cur = *queue.begin(); queue.erase(*queue.begin());
       // cout << cur.first << " " << cur.second << endl;
       if (cars[cur.second].time > T) continue;
+      if (run_control::stopped()) break; // the itineraries so far are a valid solution
 
       // only insert into queue if new edges are added
       if (assign_next_edges(cars[cur.second])) queue.insert({cars[cur.second].time, cur.second});
@@ -159,6 +189,7 @@ public:
 };
 
 
+#ifndef NO_MAIN // the kernel benchmarks in bench/ include this file
 instance I;
 int main(int argc, char* argv[]){
   ios::sync_with_stdio(false);
@@ -168,19 +199,20 @@ int main(int argc, char* argv[]){
     cout << "Usage: ./solve <instance name, e.g. paris_54000>" << endl;
     return 0;
   }
+  run_control::start(time_limit);
 
   // file input
   string filename = argv[1];
   string input_file = "../data/" + filename + ".in";
-  freopen(input_file.c_str(), "r", stdin);
 
   // solve problem
-  I.read();
+  read_instance(I, input_file, "2014", 1);
   cout << "instance read in. start solving problem" << endl;
   I.solve();
   cout << "assignment done! writing output!" << endl;
   // file output
   string output_file = "../out/" + filename + ".out";
-  freopen(output_file.c_str(), "w", stdout);
-  I.write();
+  fast_writer os(output_file.c_str());
+  I.write(os);
 }
+#endif
@@ -18,6 +18,11 @@
 #include <cmath>
 #include <map>
 #include <queue>
+
+#include "../../common/fast_reader.h"
+#include "../../common/fast_writer.h"
+#include "../../common/instance_cache.h"
+#include "../../common/run_control.h"
 #include "gurobi_c++.h"
 
 using namespace std;
@@ -25,6 +30,8 @@ using namespace std;
 typedef pair<int, int> pi;
 typedef vector<int> vi;
 
+double time_limit = 600; // wall-clock budget in seconds, 0 = none
+
 class server{
 public:
   pi position; // position of server (row r, column c)
@@ -35,6 +42,15 @@ public:
   bool allocated = false; // if this server is chosen to be used
 };
 
+// aborts the optimization once the run is stopped (time is up or a signal
+// arrived), gurobi then keeps the best assignment found so far
+class stop_callback : public GRBCallback{
+protected:
+  void callback(){
+    if (run_control::stopped()) abort();
+  }
+};
+
 // compares size per capacity for each server
 bool sizecmp(server &a, server &b){
   return double(double(a.size)/double(a.cap)) < double(double(b.size)/double(b.cap));
@@ -55,26 +71,44 @@ public:
   vector<server> servers; // all servers
 
   // reads instance
-  void read(){
-    cin >> R >> C >> U >> P >> M;
+  void read(fast_reader &in){
+    in >> R >> C >> U >> P >> M;
     unavailable.resize(R);
     for (int r = 0; r < R; r++) unavailable[r].resize(C);
     int r, c;
     for (int i = 0; i < U; i++){
-      cin >> r >> c; unavailable[r][c] = true;
+      in >> r >> c; unavailable[r][c] = true;
     }
     servers.resize(M);
     for (int i = 0; i < M; i++){
       servers[i].id = i;
-      cin >> servers[i].size >> servers[i].cap;
+      in >> servers[i].size >> servers[i].cap;
     }
   }
 
+  // instance cache: the grid is stored as R*C bytes
+  void save(cache_writer &snapshot){
+    snapshot.put(R); snapshot.put(C); snapshot.put(U); snapshot.put(P); snapshot.put(M);
+    vector<char> grid(R * C);
+    for (int r = 0; r < R; r++) for (int c = 0; c < C; c++) grid[r * C + c] = unavailable[r][c];
+    snapshot.put(grid);
+    snapshot.put(servers);
+  }
+
+  void load(cache_reader &snapshot){
+    R = snapshot.get<int>(); C = snapshot.get<int>(); U = snapshot.get<int>(); P = snapshot.get<int>(); M = snapshot.get<int>();
+    size_t n;
+    const char *grid = snapshot.view<char>(n);
+    unavailable.assign(R, vector<bool>(C));
+    for (int r = 0; r < R; r++) for (int c = 0; c < C; c++) unavailable[r][c] = grid[r * C + c];
+    snapshot.get(servers);
+  }
+
   // writes solution
-  void write(){
+  void write(fast_writer &os){
     for (server &s: servers){
-      if (!s.allocated) cout << "x" << endl;
-      else cout << s.position.first << " " << s.position.second << " " << s.pool_id << endl;
+      if (!s.allocated) os << "x\n";
+      else os << s.position.first << ' ' << s.position.second << ' ' << s.pool_id << '\n';
     }
   }
 
@@ -83,7 +117,7 @@ public:
     GRBEnv env;
     GRBModel m = GRBModel(env);
     m.getEnv().set("OutputFlag", "1");
-    m.getEnv().set("TimeLimit", "600.0");
+    m.getEnv().set(GRB_DoubleParam_TimeLimit, min(run_control::remaining(), GRB_INFINITY));
 
     vi allocated; // index set of all servers that are allocated on the grid
     for (int i = 0; i < M; i++) if (servers[i].allocated) allocated.push_back(i);
@@ -142,9 +176,16 @@ public:
       }
     }
 
+    stop_callback cb;
+    m.setCallback(&cb);
     m.optimize();
 
-    // retrieve assignment
+    // retrieve assignment. without any solution (stopped early) the servers
+    // are spread over the pools round robin, which is still valid
+    if (m.get(GRB_IntAttr_SolCount) == 0){
+      for (int k = 0; k < (int) allocated.size(); k++) servers[allocated[k]].pool_id = k % P;
+      return;
+    }
     for (int i: allocated) {
       for (int p = 0; p < P; p++){
         if (x[i][p].get(GRB_DoubleAttr_X) > 0.5){
@@ -204,19 +245,19 @@ int main(int argc, char* argv[]){
     cout << "Usage: ./solve <instance name, e.g. dc>" << endl;
     return 0;
   }
+  run_control::start(time_limit);
 
   // file input
   string filename;
   filename = argv[1];
   string input_file = "../data/" + filename + ".in";
-  freopen(input_file.c_str(), "r", stdin);
 
   instance I;
-  I.read();
+  read_instance(I, input_file, "2015-quali", 1);
   I.solve();
 
   // file output
   string output_file = "../out/" + filename + ".out";
-  freopen(output_file.c_str(), "w", stdout);
-  I.write();
+  fast_writer os(output_file.c_str());
+  I.write(os);
 }
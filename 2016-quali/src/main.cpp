@@ -23,11 +23,18 @@
 #include <cmath>
 #include <unordered_set>
 
+#include "../../common/fast_reader.h"
+#include "../../common/fast_writer.h"
+#include "../../common/instance_cache.h"
+#include "../../common/run_control.h"
+
 
 using namespace std;
 typedef vector<int> vi;
 typedef pair<int, int> pi;
 
+double time_limit = 0; // wall-clock budget in seconds, 0 = none
+
 
 
 class warehouse{
@@ -60,34 +67,85 @@ int dis(pi a, pi b){ // ceiled distance between two locations
 
 class instance{
 public:
-  void read(){
-    cin >> R >> C >> D >> T >> M;
+  void read(fast_reader &in){
+    in >> R >> C >> D >> T >> M;
     // read products
-    cin >> P;
+    in >> P;
     product_weight.resize(P,0);
-    for (int i = 0; i < P; i++) cin >> product_weight[i];
+    for (int i = 0; i < P; i++) in >> product_weight[i];
     // read in warehouses, locations, and stored items
-    cin >> W;
+    in >> W;
     warehouses.resize(W);
     for (int i = 0; i < W; i++){
       warehouses[i].id = i;
-      cin >> warehouses[i].location.first >> warehouses[i].location.second;
+      in >> warehouses[i].location.first >> warehouses[i].location.second;
       warehouses[i].items.resize(P);
-      for (int j = 0; j < P; j++) cin >> warehouses[i].items[j];
+      for (int j = 0; j < P; j++) in >> warehouses[i].items[j];
     }
     // read in customer data
-    cin >> O;
+    in >> O;
     customers.resize(O);
     for (int i = 0; i < O; i++){
       customers[i].id = i;
-      cin >> customers[i].location.first >> customers[i].location.second;
-      int n; cin >> n;
+      in >> customers[i].location.first >> customers[i].location.second;
+      int n; in >> n;
       for (int j = 0; j < n; j++){
-        int id; cin >> id;
+        int id; in >> id;
         customers[i].order.insert(id);
       }
     }
-    // read in drones
+    init_drones();
+  }
+
+  // instance cache: warehouse stock and customer orders are stored as flat arrays
+  void save(cache_writer &snapshot){
+    int header[8] = {R, C, D, T, M, P, W, O};
+    snapshot.put(header, 8);
+    snapshot.put(product_weight);
+    vector<pi> locations;
+    vi stock, order_begin = {0}, orders;
+    for (warehouse &w: warehouses){
+      locations.push_back(w.location);
+      stock.insert(stock.end(), w.items.begin(), w.items.end());
+    }
+    for (customer &c: customers){
+      locations.push_back(c.location);
+      orders.insert(orders.end(), c.order.begin(), c.order.end());
+      order_begin.push_back(orders.size());
+    }
+    snapshot.put(locations);
+    snapshot.put(stock);
+    snapshot.put(order_begin);
+    snapshot.put(orders);
+  }
+
+  void load(cache_reader &snapshot){
+    size_t n;
+    const int *header = snapshot.view<int>(n);
+    R = header[0]; C = header[1]; D = header[2]; T = header[3];
+    M = header[4]; P = header[5]; W = header[6]; O = header[7];
+    snapshot.get(product_weight);
+    const pi *locations = snapshot.view<pi>(n);
+    const int *stock = snapshot.view<int>(n);
+    const int *order_begin = snapshot.view<int>(n);
+    const int *orders = snapshot.view<int>(n);
+    warehouses.resize(W);
+    for (int i = 0; i < W; i++){
+      warehouses[i].id = i;
+      warehouses[i].location = locations[i];
+      warehouses[i].items.assign(stock + i * P, stock + (i + 1) * P);
+    }
+    customers.resize(O);
+    for (int i = 0; i < O; i++){
+      customers[i].id = i;
+      customers[i].location = locations[W + i];
+      customers[i].order.insert(orders + order_begin[i], orders + order_begin[i + 1]);
+    }
+    init_drones();
+  }
+
+  // all drones start at the first warehouse
+  void init_drones(){
     drones.resize(D);
     for (int i = 0; i < D; i++){
       drones[i].id = i;
@@ -97,18 +155,18 @@ public:
 
   // writes output as described in problem specs
   // output was stored in out object
-  void write(){
-    cout << out.size() << endl;
+  void write(fast_writer &os){
+    os << out.size() << '\n';
     for (auto v: out){
-      cout << v[0] << " ";
-      if (v[1] == 3) cout << "W " << v[2];
+      os << v[0] << ' ';
+      if (v[1] == 3) os << "W " << v[2];
       else{
-        if (v[1] == 0) cout << "L ";
-        else if (v[1] == 1) cout << "D ";
-        else if (v[1] == 2) cout << "U ";
-        cout << v[2] << " " << v[3] << " " << v[4];
+        if (v[1] == 0) os << "L ";
+        else if (v[1] == 1) os << "D ";
+        else if (v[1] == 2) os << "U ";
+        os << v[2] << ' ' << v[3] << ' ' << v[4];
       }
-      cout << endl;
+      os << '\n';
     }
   }
 
@@ -276,7 +334,7 @@ public:
     set<pi> queue;
     for (int i = 0; i < D; i++) queue.insert({0, i});
     // time-based simulation of assigning delivery routes to drones
-    while (!queue.empty()){
+    while (!queue.empty() && !run_control::stopped()){
       pi cur = *queue.begin(); queue.erase(*queue.begin());
       if (cur.first > T) break;
       if (greedy(drones[cur.second])) queue.insert({drones[cur.second].available_at, cur.second});
@@ -303,15 +361,17 @@ public:
 };
 
 
+#ifndef NO_MAIN // the kernel benchmarks in bench/ include this file
 int main(int argc, char* argv[]){
   instance I;
   ios::sync_with_stdio(false);
   cin.tie(0);
   string input_file = argv[1];
   string output_file = "out";
-  freopen(input_file.c_str(), "r", stdin); // redirects standard input
-  I.read();
+  run_control::start(time_limit);
+  read_instance(I, input_file, "2016-quali", 1);
   I.solve();
-  freopen(output_file.c_str(), "w", stdout); // redirects standard output
-  I.write();
+  fast_writer os(output_file.c_str());
+  I.write(os);
 }
+#endif
@@ -21,6 +21,11 @@
 #include <functional>
 #include <unordered_set>
 
+#include "../../common/fast_reader.h"
+#include "../../common/fast_writer.h"
+#include "../../common/instance_cache.h"
+#include "../../common/run_control.h"
+
 using namespace std;
 
 #define rep(i, from, to) for (ll i = from; i < ll(to); ++i)
@@ -36,6 +41,8 @@ typedef pair<ll, ll> pi;
 typedef vector<ll> vi;
 typedef vector<vector<ll> > vvi;
 
+double time_limit = 0; // wall-clock budget in seconds, 0 = none
+
 // custom comparator for priority queue
 struct mycmp {
     bool operator() (const tuple<double, ll, ll>& lhs, const tuple<double, ll, ll>& rhs) const {
@@ -44,9 +51,19 @@ struct mycmp {
 };
 
 
+// ids of the requests for one video, a range of instance::video_requests
+// or of the mapped instance cache
+struct request_list{
+  const ll *first;
+  ll n;
+  const ll *begin() const { return first; }
+  const ll *end() const { return first + n; }
+  ll size() const { return n; }
+};
+
 struct video{
   ll size; // video size
-  vi requests; // ids of all requests requesting this video
+  request_list requests; // ids of all requests requesting this video
 };
 
 struct endpoint{
@@ -74,12 +91,13 @@ struct instance{
   vector<endpoint> endpoints;
   vector<request> requests;
   vector<cache> caches;
+  vi video_requests; // request ids grouped by video, empty when loaded from the cache
 
   // read instance
-  void read(){
-    cin >> V >> E >> R >> C >> X;
+  void read(fast_reader &in){
+    in >> V >> E >> R >> C >> X;
     videos.resize(V);
-    rep(i, 0, V) cin >> videos[i].size;
+    rep(i, 0, V) in >> videos[i].size;
     caches.resize(C);
     rep(i, 0, C){
       caches[i].id = i;
@@ -89,28 +107,89 @@ struct instance{
     ll nbr_connected_cache_servers, cache_id;
     trav(e, endpoints){
       e.cache_time.resize(C, 10000); // if no connection from e to c, use big M
-      cin >> e.latency_to_data_center >> nbr_connected_cache_servers;
+      in >> e.latency_to_data_center >> nbr_connected_cache_servers;
       rep(j, 0, nbr_connected_cache_servers){
-        cin >> cache_id;
-        cin >> e.cache_time[cache_id];
+        in >> cache_id;
+        in >> e.cache_time[cache_id];
       }
     }
+    // one request per line, parsed in parallel chunks
     requests.resize(R);
-    rep(i, 0, R){
-      auto &r = requests[i];
-      cin >> r.video_id >> r.endpoint_id >> r.number_requests;
-      r.current_latency = endpoints[r.endpoint_id].latency_to_data_center;
-      videos[r.video_id].requests.pb(i);
+    line_chunks chunks(in, R);
+    chunks.parse([&](fast_reader &chunk, int part, ll first, ll count){
+      rep(i, first, first + count){
+        auto &r = requests[i];
+        chunk >> r.video_id >> r.endpoint_id >> r.number_requests;
+        r.current_latency = endpoints[r.endpoint_id].latency_to_data_center;
+      }
+    });
+    // group request ids by video (counting sort keeps them in input order)
+    vi begin(V + 1, 0);
+    trav(r, requests) begin[r.video_id + 1]++;
+    rep(v, 0, V) begin[v + 1] += begin[v];
+    video_requests.resize(R);
+    vi pos(begin.begin(), begin.end() - 1);
+    rep(i, 0, R) video_requests[pos[requests[i].video_id]++] = i;
+    rep(v, 0, V) videos[v].requests = {video_requests.data() + begin[v], begin[v + 1] - begin[v]};
+  }
+
+  // instance cache: latencies as a flat E x C array, request lists stay in the mapping
+  void save(cache_writer &snapshot){
+    ll header[5] = {V, E, R, C, X};
+    snapshot.put(header, 5);
+    vi sizes, latency, cache_time;
+    trav(v, videos) sizes.pb(v.size);
+    trav(e, endpoints){
+      latency.pb(e.latency_to_data_center);
+      cache_time.insert(cache_time.end(), all(e.cache_time));
+    }
+    snapshot.put(sizes);
+    snapshot.put(latency);
+    snapshot.put(cache_time);
+    snapshot.put(requests);
+    vi counts;
+    trav(v, videos) counts.pb(v.requests.size());
+    snapshot.put(counts);
+    vi grouped;
+    trav(v, videos) grouped.insert(grouped.end(), all(v.requests));
+    snapshot.put(grouped);
+  }
+
+  void load(cache_reader &snapshot){
+    size_t n;
+    const ll *header = snapshot.view<ll>(n);
+    V = header[0]; E = header[1]; R = header[2]; C = header[3]; X = header[4];
+    const ll *sizes = snapshot.view<ll>(n);
+    const ll *latency = snapshot.view<ll>(n);
+    const ll *cache_time = snapshot.view<ll>(n);
+    videos.resize(V);
+    rep(i, 0, V) videos[i].size = sizes[i];
+    endpoints.resize(E);
+    rep(i, 0, E){
+      endpoints[i].latency_to_data_center = latency[i];
+      endpoints[i].cache_time.assign(cache_time + i * C, cache_time + (i + 1) * C);
+    }
+    snapshot.get(requests);
+    const ll *counts = snapshot.view<ll>(n);
+    const ll *grouped = snapshot.view<ll>(n);
+    rep(v, 0, V){
+      videos[v].requests = {grouped, counts[v]};
+      grouped += counts[v];
+    }
+    caches.resize(C);
+    rep(i, 0, C){
+      caches[i].id = i;
+      caches[i].capacity = X;
     }
   }
 
   // write instance
-  void write(){
-    cout << C << endl;
+  void write(fast_writer &os){
+    os << C << '\n';
     trav(c, caches){
-      cout << c.id << " ";
-      trav(video_id, c.available_videos) cout << video_id << " ";
-      cout << endl;
+      os << c.id << ' ';
+      trav(video_id, c.available_videos) os << video_id << ' ';
+      os << '\n';
     }
   }
 
@@ -184,7 +263,7 @@ struct instance{
 
     double old_value, new_value;
     ll video_id, cache_id;
-    while (!video_queue.empty()){
+    while (!video_queue.empty() && !run_control::stopped()){
       tie(old_value, video_id, cache_id) = *video_queue.begin();
       video_queue.erase(video_queue.begin());
       if (old_value < 1e-9) break;
@@ -200,19 +279,21 @@ struct instance{
   }
 };
 
+#ifndef NO_MAIN // the kernel benchmarks in bench/ include this file
 instance I;
 int main(int argc, char* argv[]){
   ios::sync_with_stdio(false);
   cin.tie(0);
   string input_file = argv[1];
   string output_file = "out";
-  freopen(input_file.c_str(), "r", stdin); // redirects standard input
-  I.read();
+  run_control::start(time_limit);
+  read_instance(I, input_file, "2017-quali", 1);
   I.solve();
   I.eval();
-  freopen(output_file.c_str(), "w", stdout); // redirects standard output
-  I.write();
+  fast_writer os(output_file.c_str());
+  I.write(os);
 }
+#endif
 
 // trending today: 499966
 // me_at_the_zoo:  507906
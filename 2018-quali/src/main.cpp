@@ -20,6 +20,15 @@
 #include <tuple>
 #include <functional>
 #include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+
+#include "../../common/fast_reader.h"
+#include "../../common/fast_writer.h"
+#include "../../common/instance_cache.h"
+#include "../../common/run_control.h"
 
 using namespace std;
 
@@ -36,6 +45,8 @@ typedef pair<ll, ll> pi;
 typedef vector<ll> vi;
 typedef vector<vector<ll> > vvi;
 
+int restarts = 10000; // randomized greedy runs
+double time_limit = 0; // wall-clock budget in seconds, 0 = none
 
 struct pt{
   ll r, c;
@@ -91,16 +102,39 @@ struct instance{
   vector<Vehicle> Vehicles;
 
   // read instance
-  void read(){
-    cin >> R >> C >> F >> N >> B >> T;
+  void read(fast_reader &in){
+    in >> R >> C >> F >> N >> B >> T;
+    init_vehicles();
+    // one ride per line, parsed in parallel chunks
+    Rides.resize(N);
+    line_chunks chunks(in, N);
+    chunks.parse([&](fast_reader &chunk, int part, ll first, ll count){
+      rep(i, first, first + count){
+        chunk >> Rides[i].start.r >> Rides[i].start.c >>
+        Rides[i].finish.r >> Rides[i].finish.c >> Rides[i].earliest_start >> Rides[i].latest_finish;
+        Rides[i].id = i;
+      }
+    });
+  }
+
+  // instance cache: the rides are stored as they are
+  void save(cache_writer &snapshot){
+    ll header[6] = {R, C, F, N, B, T};
+    snapshot.put(header, 6);
+    snapshot.put(Rides);
+  }
+
+  void load(cache_reader &snapshot){
+    size_t n;
+    const ll *header = snapshot.view<ll>(n);
+    R = header[0]; C = header[1]; F = header[2]; N = header[3]; B = header[4]; T = header[5];
+    snapshot.get(Rides);
+    init_vehicles();
+  }
+
+  void init_vehicles(){
     Vehicles.resize(F);
     rep(i, 0, F) Vehicles[i].id = i;
-    Rides.resize(N);
-    rep(i, 0, N){
-      cin >> Rides[i].start.r >> Rides[i].start.c >>
-      Rides[i].finish.r >> Rides[i].finish.c >> Rides[i].earliest_start >> Rides[i].latest_finish;
-      Rides[i].id = i;
-    }
   }
 
   void get_upper_bound(){
@@ -165,7 +199,7 @@ struct instance{
 
       rep(i, 0, j) random_shuffle(all(queue2));
 
-      while (!queue2.empty()){
+      while (!queue2.empty() && !run_control::stopped()){
           random_shuffle(all(queue2));
           //Vehicle* cur_veh = *queue.begin();
           //queue.erase(queue.begin());
@@ -186,11 +220,11 @@ struct instance{
     return instance_score;
   }
 
-  void write() {
+  void write(fast_writer &os) {
     rep(i, 0, F){
-      cout << Vehicles[i].rides.size();
-      for (int i: Vehicles[i].rides) cout << " " << i;
-      cout << endl;
+      os << Vehicles[i].rides.size();
+      for (int i: Vehicles[i].rides) os << ' ' << i;
+      os << '\n';
     }
   }
 
@@ -218,17 +252,96 @@ struct instance{
 
 };
 
+// persists improving solutions on a background thread so the restart loop
+// never waits for the disk. submit() only copies the routes into the pending
+// slot; if several improvements arrive while a write is in progress, only the
+// latest one is written. files are written to a temporary name first and then
+// renamed, so an output file is either complete or absent.
+struct checkpoint_writer{
+  mutex mtx;
+  condition_variable cv;
+  bool pending = false, stop = false;
+  string pending_file;
+  vector<vector<int> > pending_rides;
+  thread worker;
+
+  checkpoint_writer(){
+    worker = thread([this]{ run(); });
+  }
+
+  ~checkpoint_writer(){
+    finish();
+  }
+
+  void submit(const string &output_file, vector<Vehicle> &vehicles){
+    lock_guard<mutex> lock(mtx);
+    pending_file = output_file;
+    pending_rides.resize(vehicles.size());
+    rep(i, 0, vehicles.size()) pending_rides[i] = vehicles[i].rides;
+    pending = true;
+    cv.notify_one();
+  }
+
+  // writes the pending solution (if any) and stops the worker
+  void finish(){
+    if (!worker.joinable()) return;
+    {
+      lock_guard<mutex> lock(mtx);
+      stop = true;
+    }
+    cv.notify_one();
+    worker.join();
+  }
+
+  static bool write_atomic(const string &output_file, vector<vector<int> > &rides){
+    string tmp_file = output_file + ".tmp";
+    bool ok;
+    {
+      fast_writer os(tmp_file.c_str());
+      trav(v, rides){
+        os << sz(v);
+        for (int i: v) os << ' ' << i;
+        os << '\n';
+      }
+      ok = os.close();
+    }
+    if (ok) ok = rename(tmp_file.c_str(), output_file.c_str()) == 0;
+    if (!ok) remove(tmp_file.c_str());
+    return ok;
+  }
+
+  void run(){
+    string file;
+    vector<vector<int> > rides;
+    while (true){
+      {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this]{ return pending || stop; });
+        if (!pending) return;
+        swap(file, pending_file);
+        swap(rides, pending_rides);
+        pending = false;
+      }
+      if (!write_atomic(file, rides)) cerr << "could not write " << file << endl;
+    }
+  }
+};
+
+#ifndef NO_MAIN // the kernel benchmarks in bench/ include this file
 instance I;
 int main(int argc, char* argv[]){
   ios::sync_with_stdio(false);
   cin.tie(0);
   string input_file = argv[1];
+  run_control::start(time_limit);
 
-  freopen(input_file.c_str(), "r", stdin); // redirects standard input
-  I.read();
+  read_instance(I, input_file, "2018-quali", 1);
   I.get_upper_bound();
+  checkpoint_writer writer;
   ll best = 0;
-  rep(i, 0, 10000){
+  // restarts until the budget is used up or a signal arrives. the best run is
+  // already with the writer; an interrupted run is still a valid solution
+  for (ll i = 0; i < restarts && !run_control::stopped(); i++){
     for (Vehicle &v: I.Vehicles) {
       v.rides.clear();
       v.position = pt(0,0);
@@ -242,15 +355,12 @@ int main(int argc, char* argv[]){
       best = I.instance_score;
       cerr << best << endl;
       I.evaluate();
-      string output_file = input_file + "out" + to_string(I.instance_score);
-      freopen(output_file.c_str(), "w", stdout); // redirects standard output
-      I.write();
+      writer.submit(input_file + "out" + to_string(I.instance_score), I.Vehicles);
     }
   }
 
-  ll score = I.get_solution_score();
-  I.evaluate();
-  string output_file = input_file + "out" + to_string(score);
-  freopen(output_file.c_str(), "w", stdout); // redirects standard output
-  I.write();
+  // every improvement has been handed to the writer; wait for the last one
+  writer.finish();
+  cerr << "best: " << best << endl;
 }
+#endif
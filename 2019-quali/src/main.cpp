@@ -12,6 +12,16 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <random>
+#include <cstdint>
+#include <immintrin.h>
+#include <omp.h>
+#include <chrono>
+#include <numeric>
+
+#include "../../common/fast_reader.h"
+#include "../../common/fast_writer.h"
+#include "../../common/instance_cache.h"
+#include "../../common/run_control.h"
 
 using namespace std;
 
@@ -29,21 +39,35 @@ typedef pair<ll, ll> pi;
 typedef vector<ll> vi;
 typedef vector<vector<ll> > vvi;
 
-const int MAXN = 100001;
+int nbr_candidates = 20; // number of best neighbours kept per slide
+
+// minhash/lsh neighbour search (./solve <input> lsh [bands] [rows])
+bool use_lsh = false;
+int lsh_bands = 16; // number of bands, each gives one chance to collide
+int lsh_rows = 2; // minhashes per band, more rows = stricter buckets
+int lsh_window = 8; // slides in a bucket are paired with this many successors
 
-int parent[MAXN];
-int rang[MAXN];
+int pair_window = 64; // candidates tried when pairing a vertical photo
+double improve_seconds = 10.0; // wall-clock budget of the local search
+double time_limit = 0; // wall-clock budget of the whole run in seconds, 0 = none
+int max_reversal = 1000; // longest segment reversed by a 2-opt move
 
-void make_set(int v) {
-    parent[v] = v;
-    rang[v] = 1;
+vector<int> parent;
+vector<int> rang;
+
+void make_sets(int n) {
+    parent.resize(n);
+    iota(parent.begin(), parent.end(), 0);
+    rang.assign(n, 1);
 }
 
+// path halving instead of recursion, deep trees cannot overflow the stack
 int find_set(int v) {
-    if (v == parent[v]) {
-        return v;
+    while (v != parent[v]) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
     }
-    return parent[v] = find_set(parent[v]);
+    return v;
 }
 
 bool union_sets(int a, int b) {
@@ -75,83 +99,446 @@ struct hash_pair {
     }
 };
 
+// interned tag ids of one photo, sorted increasingly. a range of
+// instance::photo_tags or of the mapped instance cache
+struct tag_list{
+    const uint32_t* first = 0;
+    int n = 0;
+    const uint32_t* begin() const { return first; }
+    const uint32_t* end() const { return first + n; }
+    const uint32_t* data() const { return first; }
+    int size() const { return n; }
+};
+
 struct Photo{
     int id;
     bool horizontal = false;
-    vector<string> tags;
+    tag_list tags;
 };
 
+// number of common elements of two sorted, duplicate-free id arrays.
+// plain merge for arrays of similar length, galloping search of the longer
+// array if the lengths differ a lot.
+int intersect_scalar(const uint32_t* a, int na, const uint32_t* b, int nb){
+  int i = 0, j = 0, cnt = 0;
+  while (i < na && j < nb){
+    uint32_t x = a[i], y = b[j];
+    cnt += (x == y);
+    i += (x <= y);
+    j += (y <= x);
+  }
+  return cnt;
+}
+
+int intersect_galloping(const uint32_t* a, int na, const uint32_t* b, int nb){
+  // a is the short array. for each of its elements, b is searched with
+  // doubling steps from the last position and then bisected
+  int j = 0, cnt = 0;
+  rep(i, 0, na){
+    uint32_t x = a[i];
+    int step = 1, hi = j;
+    while (hi < nb && b[hi] < x){
+      j = hi + 1;
+      hi += step;
+      step <<= 1;
+    }
+    j = lower_bound(b + j, b + min(hi + 1, nb), x) - b;
+    if (j == nb) break;
+    if (b[j] == x) cnt++;
+  }
+  return cnt;
+}
+
+// blocks of 8 ids of a are compared against all 8 rotations of the current
+// block of b; the block with the smaller maximum is advanced. the tails are
+// finished by the scalar merge.
+__attribute__((target("avx2")))
+int intersect_avx2(const uint32_t* a, int na, const uint32_t* b, int nb){
+  int i = 0, j = 0, cnt = 0;
+  const __m256i rot = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+  while (i + 8 <= na && j + 8 <= nb){
+    __m256i va = _mm256_loadu_si256((const __m256i*) (a + i));
+    __m256i vb = _mm256_loadu_si256((const __m256i*) (b + j));
+    __m256i m = _mm256_cmpeq_epi32(va, vb);
+    rep(r, 1, 8){
+      vb = _mm256_permutevar8x32_epi32(vb, rot);
+      m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));
+    }
+    cnt += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+    uint32_t amax = a[i + 7], bmax = b[j + 7];
+    if (amax <= bmax) i += 8;
+    if (bmax <= amax) j += 8;
+  }
+  return cnt + intersect_scalar(a + i, na - i, b + j, nb - j);
+}
+
+const bool has_avx2 = __builtin_cpu_supports("avx2");
+
+int intersect(const uint32_t* a, int na, const uint32_t* b, int nb){
+  if (na > nb){
+    swap(a, b);
+    swap(na, nb);
+  }
+  if (na * 32 < nb) return intersect_galloping(a, na, b, nb);
+  if (has_avx2 && na >= 8) return intersect_avx2(a, na, b, nb);
+  return intersect_scalar(a, na, b, nb);
+}
+
 struct instance{
   ll N; // from problem description
   vector<Photo> photos;
+  vector<uint32_t> photo_tags; // tags of all photos, empty when loaded from the cache
+  int nbr_tags = 0; // number of distinct tags
+
+  // photos of each slide
+  vector<vector<int> > preslideshow;
+  // sorted tag ids of all slides in one buffer. slide i owns the range
+  // [slide_begin[i], slide_begin[i+1]) of slide_tags
+  vector<uint32_t> slide_tags;
+  vector<int> slide_begin;
 
-  // slideshow
-  vector<vector<int> > slideshow;
+  // slideshow (as slide indices into preslideshow)
+  vector<int> slideshow;
 
   ll instance_score = 0;
   // stores the respective objects
 
   // read instance
-  void read(){
-    cin >> N;
+  // tags are interned to dense ids while reading, so that all scoring works
+  // on sorted integer arrays instead of strings
+  void read(fast_reader &in){
+    in >> N;
+    photos.resize(N);
+    // one photo per line, parsed in parallel chunks. every chunk interns its tags locally
+    // (tags point into the mapped input), local ids are then mapped to global ids
+    // in order of first appearance, as if the file had been read sequentially
+    line_chunks chunks(in, N);
+    vector<vector<uint32_t> > tags(N);
+    vector<unordered_map<token, uint32_t, token_hash> > local_ids(chunks.size());
+    vector<vector<token> > local_tags(chunks.size());
+    chunks.parse([&](fast_reader &chunk, int part, ll first, ll count){
+      auto &ids = local_ids[part];
+      token tag;
+      int k;
+      char c;
+      rep(i, first, first + count){
+        photos[i].id = i;
+        chunk >> c;
+        if (c == 'H') photos[i].horizontal = true;
+        chunk >> k;
+        tags[i].resize(k);
+        rep(j, 0, k){
+          chunk >> tag;
+          auto it = ids.emplace(tag, (uint32_t) ids.size());
+          if (it.second) local_tags[part].pb(tag);
+          tags[i][j] = it.first->second;
+        }
+      }
+    });
+    unordered_map<token, uint32_t, token_hash> tag_ids;
+    vector<vector<uint32_t> > global_id(chunks.size());
+    rep(part, 0, chunks.size()){
+      trav(tag, local_tags[part]) global_id[part].pb(tag_ids.emplace(tag, (uint32_t) tag_ids.size()).first->second);
+    }
+    rep(part, 0, chunks.size()){
+      #pragma omp parallel for
+      for (ll i = chunks.begin_id(part); i < chunks.end_id(part); i++){
+        trav(t, tags[i]) t = global_id[part][t];
+        sort(all(tags[i]));
+        tags[i].erase(unique(all(tags[i])), tags[i].end());
+      }
+    }
+    nbr_tags = tag_ids.size();
+    // one buffer for all photos
+    vector<ll> begin(N + 1, 0);
+    rep(i, 0, N) begin[i + 1] = begin[i] + tags[i].size();
+    photo_tags.resize(begin[N]);
+    #pragma omp parallel for
+    for (ll i = 0; i < N; i++){
+      copy(all(tags[i]), photo_tags.begin() + begin[i]);
+      photos[i].tags = {photo_tags.data() + begin[i], (int) tags[i].size()};
+    }
+  }
+
+  // instance cache: photo orientations and tag counts, the tags stay in the mapping
+  void save(cache_writer &snapshot){
+    snapshot.put(N);
+    snapshot.put(nbr_tags);
+    vector<char> horizontal;
+    vector<int> counts;
+    vector<uint32_t> tags;
+    trav(p, photos){
+      horizontal.pb(p.horizontal);
+      counts.pb(p.tags.size());
+      tags.insert(tags.end(), all(p.tags));
+    }
+    snapshot.put(horizontal);
+    snapshot.put(counts);
+    snapshot.put(tags);
+  }
+
+  void load(cache_reader &snapshot){
+    N = snapshot.get<ll>();
+    nbr_tags = snapshot.get<int>();
+    size_t n;
+    const char* horizontal = snapshot.view<char>(n);
+    const int* counts = snapshot.view<int>(n);
+    const uint32_t* tags = snapshot.view<uint32_t>(n);
     photos.resize(N);
-    int nbr_tags;
-    char c;
     rep(i, 0, N){
       photos[i].id = i;
-      cin >> c;
-      if (c == 'H') photos[i].horizontal = true;
-      cin >> nbr_tags;
-      photos[i].tags.resize(nbr_tags);
-      rep(j, 0, nbr_tags) cin >> photos[i].tags[j];
+      photos[i].horizontal = horizontal[i];
+      photos[i].tags = {tags, counts[i]};
+      tags += counts[i];
+    }
+  }
+
+  // fills slide_tags/slide_begin with the tag union of every slide
+  void build_slide_tags(){
+    int n = preslideshow.size();
+    slide_begin.assign(n + 1, 0);
+    rep(i, 0, n) trav(pid, preslideshow[i]) slide_begin[i + 1] += photos[pid].tags.size();
+    rep(i, 0, n) slide_begin[i + 1] += slide_begin[i];
+    slide_tags.resize(slide_begin[n]);
+    int pos = 0;
+    rep(i, 0, n){
+      slide_begin[i] = pos;
+      vector<int>& s = preslideshow[i];
+      if (s.size() == 1){
+        tag_list& t = photos[s[0]].tags;
+        pos = copy(all(t), slide_tags.begin() + pos) - slide_tags.begin();
+      }
+      else {
+        tag_list& t1 = photos[s[0]].tags;
+        tag_list& t2 = photos[s[1]].tags;
+        pos = set_union(all(t1), all(t2), slide_tags.begin() + pos) - slide_tags.begin();
+      }
     }
+    slide_begin[n] = pos;
+    slide_tags.resize(pos);
   }
 
-  ll get_score(vector<int> &a, vector<int> &b){
-    set<string> first_string_set, second_string_set;
-    for(int el: a) for (string s: photos[el].tags) first_string_set.insert(s);
-    for(int el: b) for (string s: photos[el].tags) second_string_set.insert(s);
+  int slide_size(int i){
+    return slide_begin[i + 1] - slide_begin[i];
+  }
 
-    int inter = 0;
-    for (string s : first_string_set) if (second_string_set.find(s) != second_string_set.end()) inter++;
+  const uint32_t* slide_tag_ptr(int i){
+    return slide_tags.data() + slide_begin[i];
+  }
 
-    ll ret = min(min((int)first_string_set.size(),(int) second_string_set.size()) - inter, inter);
-    // print(first_string_set);
-    // print(second_string_set);
-    // cout << ret << endl;
-    return ret;
+  // interest factor of the transition between slides a and b
+  int get_score(int a, int b){
+    int na = slide_size(a), nb = slide_size(b);
+    int inter = intersect(slide_tag_ptr(a), na, slide_tag_ptr(b), nb);
+    return min(min(na, nb) - inter, inter);
   }
 
-  int get_fast_score(set<string>& first_string_set, set<string>& second_string_set){
-    int inter = 0;
-    for (string s : first_string_set) if (second_string_set.find(s) != second_string_set.end()) inter++;
+  // collects for every slide the nbr_candidates slides with the highest
+  // transition score. shared tags are counted by walking the tag->slide
+  // inverted index with a counting array that is reset after each slide, so
+  // memory stays at O(nbr_candidates * n) besides the index itself.
+  // slides are processed in parallel, each thread with its own counting array.
+  // ties are broken by a hash of the pair; otherwise every slide would keep
+  // the same few low-index slides and most of them could not be linked.
+  static uint32_t pair_hash(uint32_t a, uint32_t b){
+    uint64_t x = (uint64_t) min(a, b) << 32 | max(a, b);
+    x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL;
+    return x >> 32;
+  }
 
-    return min(min((int)first_string_set.size(),(int) second_string_set.size()) - inter, inter);
+  void get_candidates(vector<pair<pair<int,int>,int>>& vecscores){
+    int n = preslideshow.size();
+    int k = nbr_candidates;
+
+    // inverted index in compressed form: slides having tag t are
+    // tag_slides[tag_begin[t], tag_begin[t+1])
+    vector<int> tag_begin(nbr_tags + 1, 0);
+    trav(t, slide_tags) tag_begin[t + 1]++;
+    rep(t, 0, nbr_tags) tag_begin[t + 1] += tag_begin[t];
+    vector<int> tag_slides(slide_tags.size());
+    vector<int> pos(all(tag_begin));
+    rep(i, 0, n) rep(j, slide_begin[i], slide_begin[i + 1]) tag_slides[pos[slide_tags[j]]++] = i;
+
+    // best[i*k .. i*k+found[i]) are the candidates of slide i as
+    // (score << 32 | tie breaker, slide)
+    vector<pair<ll, int> > best((ll) n * k);
+    vector<int> found(n, 0);
+
+    #pragma omp parallel
+    {
+      vector<int> cnt(n, 0);
+      vector<int> touched;
+      #pragma omp for schedule(dynamic, 256)
+      for (int i = 0; i < n; i++){
+        touched.clear();
+        rep(j, slide_begin[i], slide_begin[i + 1]){
+          uint32_t t = slide_tags[j];
+          rep(l, tag_begin[t], tag_begin[t + 1]){
+            int o = tag_slides[l];
+            if (o == i) continue;
+            if (cnt[o]++ == 0) touched.pb(o);
+          }
+        }
+        // min-heap of size k on the score
+        pair<ll, int>* heap = best.data() + (ll) i * k;
+        int h = 0;
+        int si = slide_size(i);
+        trav(o, touched){
+          int sc = min(min(si, slide_size(o)) - cnt[o], cnt[o]);
+          cnt[o] = 0;
+          if (sc <= 0) continue;
+          ll key = (ll) sc << 32 | pair_hash(i, o);
+          if (h < k){
+            heap[h++] = {key, o};
+            push_heap(heap, heap + h, greater<pair<ll, int> >());
+          }
+          else if (key > heap[0].fi){
+            pop_heap(heap, heap + h, greater<pair<ll, int> >());
+            heap[h - 1] = {key, o};
+            push_heap(heap, heap + h, greater<pair<ll, int> >());
+          }
+        }
+        found[i] = h;
+      }
+    }
 
+    // pairs found from both sides appear twice, the linking skips the second one
+    rep(i, 0, n) rep(r, 0, found[i]){
+      pair<ll, int>& c = best[i * k + r];
+      vecscores.pb({{min((int) i, c.se), max((int) i, c.se)}, int(c.fi >> 32)});
+    }
+  }
+
+  static uint32_t minhash(uint32_t tag, uint32_t seed){
+    uint64_t x = ((uint64_t) seed << 32 | tag) * 0x9e3779b97f4a7c15ULL;
+    x ^= x >> 29; x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 32;
+    return x;
+  }
+
+  // alternative to get_candidates that avoids walking long posting lists.
+  // every slide gets lsh_bands * lsh_rows minhash values; slides whose
+  // minhashes agree on all rows of some band land in the same bucket and are
+  // proposed as pairs. inside a bucket every slide is only paired with its
+  // next lsh_window members, so the work is linear in the number of slides.
+  // proposed pairs are scored exactly and handed to the same linking.
+  void get_lsh_candidates(vector<pair<pair<int,int>,int>>& vecscores){
+    int n = preslideshow.size();
+    int m = lsh_bands * lsh_rows;
+
+    vector<uint32_t> sig((ll) n * m);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++){
+      rep(r, 0, m){
+        uint32_t mn = UINT32_MAX;
+        rep(j, slide_begin[i], slide_begin[i + 1]) mn = min(mn, minhash(slide_tags[j], r));
+        sig[(ll) i * m + r] = mn;
+      }
+    }
+
+    vector<pair<int, int> > pairs;
+    #pragma omp parallel
+    {
+      vector<pair<uint64_t, int> > keys(n);
+      vector<pair<int, int> > local;
+      #pragma omp for schedule(dynamic, 1)
+      for (int b = 0; b < lsh_bands; b++){
+        rep(i, 0, n){
+          uint64_t key = b;
+          rep(r, 0, lsh_rows) key = key * 0x100000001b3ULL ^ sig[(ll) i * m + b * lsh_rows + r];
+          keys[i] = {key, i};
+        }
+        sort(all(keys));
+        for (int p = 0; p < n; p++){
+          for (int q = p + 1; q < n && q <= p + lsh_window && keys[q].fi == keys[p].fi; q++){
+            local.pb({keys[p].se, keys[q].se});
+          }
+        }
+      }
+      #pragma omp critical
+      pairs.insert(pairs.end(), all(local));
+    }
+
+    sort(all(pairs));
+    pairs.erase(unique(all(pairs)), pairs.end());
+    cerr << "lsh pairs: " << pairs.size() << endl;
+    trav(p, pairs){
+      int sc = get_score(p.fi, p.se);
+      if (sc > 0) vecscores.pb({p, sc});
+    }
   }
 
-  void assign(int cur, vector<vector<int>>& edges, vector<vector<int>>& preslideshow,
-        vector<bool>& used, int n){
+  // pairs the vertical photos so that the two photos of a slide share as few
+  // tags as possible (= the union is as large as possible). the photos are
+  // bucketed by tag count; the unpaired photo with the most tags is paired
+  // with the best of the pair_window unpaired photos with the fewest tags,
+  // which also keeps the slide sizes balanced. linear in the number of
+  // verticals times pair_window.
+  void pair_verticals(vector<int>& verticals){
+    int max_tags = 0;
+    trav(v, verticals) max_tags = max(max_tags, (int) photos[v].tags.size());
+    vector<vector<int> > buckets(max_tags + 1);
+    trav(v, verticals) buckets[photos[v].tags.size()].pb(v);
+    vector<int> order; // by decreasing tag count
+    for (int c = max_tags; c >= 0; c--) order.insert(order.end(), all(buckets[c]));
+
+    // unpaired photos as doubly linked list over order, m is the sentinel
+    int m = order.size();
+    vector<int> nxt(m + 1), prv(m + 1);
+    rep(i, 0, m + 1){
+      nxt[i] = (i + 1) % (m + 1);
+      prv[i] = (i + m) % (m + 1);
+    }
+    auto unlink = [&](int i){
+      nxt[prv[i]] = nxt[i];
+      prv[nxt[i]] = prv[i];
+    };
+
+    int left = m;
+    while (left >= 2){
+      int a = nxt[m];
+      unlink(a);
+      tag_list& ta = photos[order[a]].tags;
+      int best = -1, best_inter = INT32_MAX;
+      int tries = 0;
+      for (int b = prv[m]; b != m && tries < pair_window; b = prv[b], tries++){
+        tag_list& tb = photos[order[b]].tags;
+        int inter = intersect(ta.data(), ta.size(), tb.data(), tb.size());
+        if (inter < best_inter){
+          best_inter = inter;
+          best = b;
+          if (inter == 0) break;
+        }
+      }
+      unlink(best);
+      left -= 2;
+      preslideshow.pb({order[a], order[best]});
+    }
+  }
+
+  // walks the path starting at end point cur. the (at most two) neighbours of
+  // slide i are adj[2*i] and adj[2*i+1], cnt[i] is their number
+  void assign(int cur, vector<int>& adj, vector<int>& cnt, vector<bool>& used, int n){
 
     int prev = cur;
-    slideshow.pb(preslideshow[cur]);
-    int next = edges[cur][0];
+    slideshow.pb(cur);
+    int next = adj[2 * cur];
     used[cur] = true;
     while(true){
       prev = cur;
       cur = next;
       used[cur] = true;
-      slideshow.pb(preslideshow[cur]);
-      if (edges[cur].size() == 1) break;
-      if (edges[cur][0] == prev) next = edges[cur][1];
-      else next = edges[cur][0];
+      slideshow.pb(cur);
+      if (cnt[cur] == 1) break;
+      if (adj[2 * cur] == prev) next = adj[2 * cur + 1];
+      else next = adj[2 * cur];
     }
   }
 
 
   void solve(){
     vector<int> verticals, horizontals;
-    vector<vector<int>> preslideshow;
 
     trav(p, photos) {
       if (!p.horizontal) verticals.pb(p.id);
@@ -159,45 +546,22 @@ struct instance{
     }
     shuffle(all(horizontals), default_random_engine(time(NULL)));
     // join verticals
-    for (int i = 0; i + 1 < (int) verticals.size(); i = i + 2){
-      preslideshow.pb({verticals[i], verticals[i+1]});
-    }
+    pair_verticals(verticals);
 
     // match horizontals
     rep(i, 0, horizontals.size()) preslideshow.pb({horizontals[i]});
-
-    unordered_map<string, vector<int> > mapping;
-    rep(i, 0, preslideshow.size()) trav(pid, preslideshow[i]) trav(s, photos[pid].tags) mapping[s].pb(i);
+    build_slide_tags();
 
     map<int, vector<pi>> score; // score of slide i to slide j
-    map<pair<int, int>,int> inter;
-
-    vector<set<string> > string_sets(preslideshow.size());
-    rep(i, 0, preslideshow.size()){
-      trav(el, preslideshow[i]){
-        trav(s, photos[el].tags) string_sets[i].insert(s);
-      }
-    }
 
-    cout << mapping.size() << endl;
+    cout << nbr_tags << endl;
 
-    trav(p, mapping){
-      auto cands = p.second;
-      cout << cands.size() << endl;
-      for (int i = 0; i < cands.size(); i++){
-          for (int j = 0; j < i; j = j + 5){
-            if (cands[i] < cands[j]) inter[{cands[i],cands[j]}]++;
-            else inter[{cands[j],cands[i]}]++;
-          }
-      }
-    }
+    vector<pair<pair<int,int>,int>> vecscores;
+    if (use_lsh) get_lsh_candidates(vecscores);
+    else get_candidates(vecscores);
 
     cout << "got score" << endl;
-    cout << inter.size() << endl;
-    vector<pair<pair<int,int>,int>> vecscores;
-    trav(p, inter){
-      vecscores.pb({p.fi, min(min((int)string_sets[p.fi.fi].size(),(int)string_sets[p.fi.se].size()) - p.se, p.se)});
-    }
+    cout << vecscores.size() << endl;
     sort(all(vecscores), [](const auto& a, const auto& b){if (a.se == b.se) return a.fi < b.fi; else return a.se > b.se;});
 
 
@@ -205,18 +569,16 @@ struct instance{
     cout << n << endl;
 
     vector<int> cnt(n, 0);
-    vector<vector<int> > edges(n);
-    rep(i, 0, n) make_set(i);
+    vector<int> adj(2 * (ll) n, -1);
+    make_sets(n);
     // smart connection
     int ii = 0;
     trav(pp, vecscores){
       int a = pp.fi.fi; int b = pp.fi.se;
       if (cnt[a] < 2 && cnt[b] < 2 && find_set(a) != find_set(b)){
 
-        cnt[a]++;
-        cnt[b]++;
-        edges[a].pb(b);
-        edges[b].pb(a);
+        adj[2 * a + cnt[a]++] = b;
+        adj[2 * b + cnt[b]++] = a;
         union_sets(a,b);
         ii++;
       }
@@ -227,7 +589,7 @@ struct instance{
 
     rep(i, 0, n){
       if (cnt[i] == 1 && !used[i]){
-        assign(i, edges, preslideshow, used, n);
+        assign(i, adj, cnt, used, n);
       }
     }
 
@@ -262,38 +624,132 @@ struct instance{
   }
 
 
+  // 2-opt: reverses p[i..j]. only the transitions at both ends change
+  int delta_2opt(int* p, int i, int j){
+    return get_score(p[i - 1], p[j]) + get_score(p[i], p[j + 1])
+         - get_score(p[i - 1], p[i]) - get_score(p[j], p[j + 1]);
+  }
+
+  // or-opt: moves the block p[i..i+len) behind position k (k < i - 1 or
+  // k >= i + len), reversed if rev. p[k+1] must exist.
+  int delta_oropt(int* p, int i, int len, int k, bool rev){
+    int first = p[i], last = p[i + len - 1];
+    if (rev) swap(first, last);
+    return get_score(p[i - 1], p[i + len]) + get_score(p[k], first) + get_score(last, p[k + 1])
+         - get_score(p[i - 1], p[i]) - get_score(p[i + len - 1], p[i + len]) - get_score(p[k], p[k + 1]);
+  }
+
+  void apply_oropt(int* p, int i, int len, int k, bool rev){
+    if (rev) reverse(p + i, p + i + len);
+    if (k < i) rotate(p + k + 1, p + i, p + i + len);
+    else rotate(p + i, p + i + len, p + k + 1);
+  }
+
+  // random 2-opt and or-opt moves on p[lo..hi). moves never touch the first
+  // and last position of the range, so ranges that do not overlap can be
+  // improved at the same time. returns the total gain.
+  ll improve_segment(int lo, int hi, mt19937& rng, int moves){
+    int* p = slideshow.data();
+    int len = hi - lo;
+    ll gain = 0;
+    rep(it, 0, moves){
+      if (rng() % 2 == 0){
+        int i = lo + 1 + rng() % (len - 2);
+        int j = i + 1 + rng() % min(max_reversal, len);
+        if (j >= hi - 1) continue;
+        int d = delta_2opt(p, i, j);
+        if (d >= 0){
+          reverse(p + i, p + j + 1);
+          gain += d;
+        }
+      }
+      else {
+        int bl = 1 + rng() % 3;
+        int i = lo + 1 + rng() % (len - 2);
+        if (i + bl >= hi) continue;
+        int k = lo + rng() % (len - 1);
+        if (k >= i - 1 && k < i + bl) continue;
+        bool rev = rng() % 2;
+        int d = delta_oropt(p, i, bl, k, rev);
+        if (d >= 0){
+          apply_oropt(p, i, bl, k, rev);
+          gain += d;
+        }
+      }
+    }
+    return gain;
+  }
+
+  // improves the slideshow by local search until the time budget is used up.
+  // each round cuts the slideshow at a random offset into segments that are
+  // improved in parallel; the cut positions move between rounds so that
+  // every transition can be changed eventually.
+  void improve(double seconds){
+    int L = slideshow.size();
+    if (L < 8) return;
+    auto start = chrono::steady_clock::now();
+    int nbr_segments = max(1, min(L / 64, 4 * omp_get_max_threads()));
+    int seg = L / nbr_segments;
+    ll total_gain = 0;
+    mt19937 round_rng(12345);
+    for (int round = 0; ; round++){
+      double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+      if (elapsed > seconds || run_control::stopped()) break;
+      int offset = round_rng() % seg;
+      ll round_gain = 0;
+      #pragma omp parallel for schedule(dynamic, 1) reduction(+:round_gain)
+      for (int sgm = 0; sgm < nbr_segments; sgm++){
+        int lo = offset + sgm * seg;
+        int hi = min(L, lo + seg);
+        if (hi - lo < 4) continue;
+        mt19937 rng(round * 7919 + sgm);
+        round_gain += improve_segment(lo, hi, rng, 20000);
+      }
+      total_gain += round_gain;
+    }
+    cerr << "local search gain: " << total_gain << endl;
+  }
+
   ll get_solution_score(){
     ll ret = 0;
-    rep(i, 0, slideshow.size() - 1) ret += get_score(slideshow[i], slideshow[i+1]);
+    rep(i, 0, (ll) slideshow.size() - 1) ret += get_score(slideshow[i], slideshow[i+1]);
     return ret;
   }
 
 
-  void write() {
-    cout << slideshow.size() << endl;
-    for (vector<int> v: slideshow){
-      for (int el : v) cout << el << " ";
-      cout << endl;
+  void write(fast_writer &os) {
+    os << slideshow.size() << '\n';
+    for (int i: slideshow){
+      for (int el : preslideshow[i]) os << el << ' ';
+      os << '\n';
     }
   }
 
 };
 
+#ifndef NO_MAIN // the kernel benchmarks in bench/ include this file
 instance I;
 int main(int argc, char* argv[]){
   ios::sync_with_stdio(false);
   cin.tie(0);
   string input_file = argv[1];
+  run_control::start(time_limit);
+  if (argc > 2 && string(argv[2]) == "lsh"){
+    use_lsh = true;
+    if (argc > 3) lsh_bands = stoi(argv[3]);
+    if (argc > 4) lsh_rows = stoi(argv[4]);
+  }
 
-  freopen(input_file.c_str(), "r", stdin); // redirects standard input
-  I.read();
+  read_instance(I, input_file, "2019-quali", 1);
   //I.get_upper_bound();
   I.solve();
+  I.improve(run_control::budget(improve_seconds));
 
   ll score = I.get_solution_score();
   cerr << score << endl;
   //I.evaluate();
   string output_file = input_file + "out" + to_string(score);
-  freopen(output_file.c_str(), "w", stdout); // redirects standard output
-  I.write();
+  fast_writer os(output_file.c_str());
+  I.write(os);
 }
+#endif
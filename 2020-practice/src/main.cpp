@@ -12,6 +12,14 @@
 #include <functional>
 #include <unordered_set>
 #include <numeric>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+
+#include "../../common/fast_reader.h"
+#include "../../common/fast_writer.h"
+#include "../../common/instance_cache.h"
+#include "../../common/run_control.h"
 
 using namespace std;
 
@@ -27,6 +35,25 @@ typedef long long ll;
 typedef pair<ll, ll> pi;
 typedef vector<ll> vi;
 typedef vector<vector<ll> > vvi;
+typedef vector<uint64_t> bits;
+
+// the bitset dp needs about M * N / 64 word operations
+const ll max_dp_work = 1000000000LL;
+double time_limit = 60.0; // wall-clock budget in seconds (bounds the branch-and-bound), 0 = none
+int bnb_split_depth = 12; // the first decisions are distributed over threads
+
+// dst |= dst << s on the first w words
+void shift_or(uint64_t* dst, ll w, ll s){
+  ll q = s >> 6, r = s & 63;
+  for (ll i = w - 1; i > q; i--){
+    dst[i] |= (dst[i - q] << r) | (r ? dst[i - q - 1] >> (64 - r) : 0);
+  }
+  if (q < w) dst[q] |= dst[0] << r;
+}
+
+bool get_bit(const bits& b, ll i){
+  return (b[i >> 6] >> (i & 63)) & 1;
+}
 
 struct pizza{
   ll index, pieces;
@@ -37,6 +64,91 @@ bool mycmp (const pizza &a, const pizza &b){
   else return a.pieces > b.pieces;
 }
 
+// depth-first branch-and-bound for subset sum with large M. pizzas are
+// sorted decreasingly; a node is closed as soon as all remaining pizzas fit
+// (their suffix sum), pizzas that do not fit anymore are skipped by binary
+// search and the search stops once M is hit exactly or the run is stopped.
+struct branch_and_bound{
+  ll M;
+  vector<ll> sizes; // decreasing
+  vector<ll> suffix; // suffix[i] = sizes[i] + ... + sizes[n-1]
+
+  atomic<ll> best{0};
+  atomic<bool> stop{false};
+  atomic<bool> timed_out{false};
+  mutex mtx;
+  vector<int> best_set; // positions in sizes
+
+  branch_and_bound(ll M, vector<ll> sizes) : M(M), sizes(sizes){
+    int n = sizes.size();
+    suffix.assign(n + 1, 0);
+    for (int i = n - 1; i >= 0; i--) suffix[i] = suffix[i + 1] + sizes[i];
+  }
+
+  void improve(ll value, vector<int>& chosen, int rest){
+    if (value <= best) return;
+    lock_guard<mutex> lock(mtx);
+    if (value <= best) return;
+    best = value;
+    best_set = chosen;
+    rep(i, rest, sizes.size()) best_set.pb(i);
+    if (value == M) stop = true;
+  }
+
+  struct worker{
+    branch_and_bound& B;
+    vector<int> chosen;
+
+    worker(branch_and_bound& B) : B(B){}
+
+    void dfs(int i, ll cur){
+      if (B.stop) return;
+      if (run_control::stopped()){
+        B.timed_out = true;
+        B.stop = true;
+        return;
+      }
+      // pizzas larger than the remaining capacity are skipped
+      i = lower_bound(B.sizes.begin() + i, B.sizes.end(), B.M - cur, greater<ll>()) - B.sizes.begin();
+      if (cur + B.suffix[i] <= B.M){
+        B.improve(cur + B.suffix[i], chosen, i);
+        return;
+      }
+      chosen.pb(i);
+      dfs(i + 1, cur + B.sizes[i]);
+      chosen.pop_back();
+      dfs(i + 1, cur);
+    }
+  };
+
+  // returns true if the result is proven optimal
+  bool run(){
+    int n = sizes.size();
+    int d = min(n, bnb_split_depth);
+    // greedy start solution
+    vector<int> greedy;
+    ll cur = 0;
+    rep(i, 0, n) if (cur + sizes[i] <= M){
+      cur += sizes[i];
+      greedy.pb(i);
+    }
+    improve(cur, greedy, n);
+
+    // every assignment of the first d pizzas is a subproblem
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (ll mask = (1LL << d) - 1; mask >= 0; mask--){
+      worker w(*this);
+      ll start = 0;
+      rep(i, 0, d) if (mask >> (d - 1 - i) & 1){
+        start += sizes[i];
+        w.chosen.pb(i);
+      }
+      if (start <= M) w.dfs(d, start);
+    }
+    return !timed_out;
+  }
+};
+
 struct instance{
   ll N, M; // from problem description
   ll init_M;
@@ -45,72 +157,99 @@ struct instance{
   vector<pizza> pizzas;
   vector<bool> taken;
   // read instance
-  void read(){
-    cin >> M >> N;
+  void read(fast_reader &in){
+    in >> M >> N;
     pizzas.resize(N);
     taken.resize(N);
     rep(i, 0, N){
-      cin >> pizzas[i].pieces;
+      in >> pizzas[i].pieces;
       pizzas[i].index = i;
     }
   }
 
-  void assign_taken(vector<pizza> &piz){
-    ll my_M = M;
-    for (pizza &p: piz){
-      if (my_M >= p.pieces){
-        my_M -= p.pieces;
-        taken[p.index] = true;
-      }
-    }
-    cout << my_M << endl;
+  // instance cache: the pizzas are stored as they are
+  void save(cache_writer &snapshot){
+    snapshot.put(M);
+    snapshot.put(N);
+    snapshot.put(pizzas);
   }
 
-  ll try_assign(vector<pizza> &piz){
-    ll my_M = M;
-    for (pizza &p: piz){
-      if (my_M >= p.pieces){
-        my_M -= p.pieces;
-      }
-    }
-    return M - my_M;
+  void load(cache_reader &snapshot){
+    M = snapshot.get<ll>();
+    N = snapshot.get<ll>();
+    snapshot.get(pizzas);
+    taken.resize(N);
+  }
+
+  // reachable sums of pizzas [lo, hi) up to t as bitset
+  void reachable(ll lo, ll hi, ll t, bits& b){
+    ll w = (t >> 6) + 1;
+    b.assign(w, 0);
+    b[0] = 1;
+    rep(i, lo, hi) if (pizzas[i].pieces <= t) shift_or(b.data(), w, pizzas[i].pieces);
+    if ((t & 63) != 63) b[w - 1] &= (uint64_t(1) << ((t & 63) + 1)) - 1;
   }
 
-  void solve_simple_sorting(){
-    //sort(all(pizzas), mycmp);
-    auto best = pizzas;
-    auto cur = pizzas;
-    ll best_score = 0;
-    rep(i, 0, 10000){
-      random_shuffle(all(cur));
-      ll new_score = try_assign(cur);
-      if (new_score > best_score){
-        best_score = new_score;
-        cout << best_score << endl;
-        best = cur;
+  // marks pizzas of [lo, hi) as taken that sum up to exactly t (t must be
+  // reachable). hirschberg-style: the reachable sums of both halves tell how
+  // t is split between them, then both halves are solved recursively.
+  // small ranges keep all dp layers and backtrack directly.
+  void reconstruct(ll lo, ll hi, ll t){
+    if (t == 0) return;
+    ll w = (t >> 6) + 1;
+    if ((hi - lo) * w <= 2 * ((M >> 6) + 1)){
+      vector<bits> layers(hi - lo + 1);
+      layers[0].assign(w, 0);
+      layers[0][0] = 1;
+      rep(i, lo, hi){
+        layers[i - lo + 1] = layers[i - lo];
+        if (pizzas[i].pieces <= t) shift_or(layers[i - lo + 1].data(), w, pizzas[i].pieces);
       }
+      for (ll i = hi - 1; i >= lo && t > 0; i--){
+        if (get_bit(layers[i - lo], t)) continue; // reachable without pizza i
+        taken[i] = true;
+        t -= pizzas[i].pieces;
+      }
+      return;
     }
-    assign_taken(best);
+    ll mid = (lo + hi) / 2;
+    bits left, right;
+    reachable(lo, mid, t, left);
+    reachable(mid, hi, t, right);
+    ll a = t;
+    while (!(get_bit(left, a) && get_bit(right, t - a))) a--;
+    bits().swap(left);
+    bits().swap(right);
+    reconstruct(lo, mid, a);
+    reconstruct(mid, hi, t - a);
   }
 
+  // exact subset sum: the best total <= M is the highest reachable sum.
+  // memory stays at a few bitsets of M bits.
   void solve_dp(){
-    unordered_map<ll, vector<int> > cands;
-    cands[0] = {};
-    for (int i = N - 1; i >= 0; i--){
-      unordered_map<ll, vector<int> > new_cands = cands;
-      for (auto p : cands){
-        ll v = p.first + pizzas[i].pieces;
-        if (v <= M){
-          new_cands[v] = p.second;
-          new_cands[v].pb(i);
-        }
-      }
-      swap(cands, new_cands);
+    ll total = 0;
+    rep(i, 0, N) total += pizzas[i].pieces;
+    ll t = min(M, total);
+    bits b;
+    reachable(0, N, t, b);
+    while (!get_bit(b, t)) t--;
+    bits().swap(b);
+    cerr << t << endl;
+    reconstruct(0, N, t);
+  }
 
-    }
-    pair<ll, vector<int>>  opt_cands = *max_element(all(cands), [](auto& p, auto& q){return p.first < q.first;});
-    cerr << opt_cands.fi << endl;
-    for (int c : opt_cands.se) taken[c] = true;
+  // exact search for M too large for the bitset dp
+  void solve_bnb(){
+    vector<pizza> order = pizzas;
+    sort(all(order), mycmp);
+    vector<ll> sizes;
+    trav(p, order) sizes.pb(p.pieces);
+    branch_and_bound B(M, sizes);
+    bool optimal = B.run();
+    ll upper_bound = min(M, accumulate(all(sizes), 0LL));
+    if (optimal) upper_bound = B.best;
+    cerr << B.best << " (upper bound " << upper_bound << ")" << endl;
+    trav(i, B.best_set) taken[order[i].index] = true;
   }
 
   ll get_score(){
@@ -119,11 +258,11 @@ struct instance{
     return ret;
   }
 
-  void write() {
+  void write(fast_writer &os) {
     ll nbr = accumulate(taken.begin(), taken.end(), 0LL);
-    cout << nbr << endl;
-    rep(i, 0, N) if (taken[i]) cout << i << " ";
-    cout << endl;
+    os << nbr << '\n';
+    rep(i, 0, N) if (taken[i]) os << i << ' ';
+    os << '\n';
   }
 };
 
@@ -133,13 +272,14 @@ int main(int argc, char* argv[]){
   cin.tie(0);
 
   string input_file = argv[1];
+  run_control::start(time_limit);
 
-  freopen(input_file.c_str(), "r", stdin); // redirects standard input
-  I.read();
-  I.solve_simple_sorting();
+  read_instance(I, input_file, "2020-practice", 1);
+  if ((I.M >> 6) * I.N <= max_dp_work) I.solve_dp();
+  else I.solve_bnb();
   ll score = I.get_score();
   string output_file = input_file + "out-" + to_string(score);
-  freopen(output_file.c_str(), "w", stdout); // redirects standard output
-  I.write();
+  fast_writer os(output_file.c_str());
+  I.write(os);
 
 }
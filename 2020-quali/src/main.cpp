@@ -13,7 +13,14 @@
 #include <unordered_map>
 #include <random>
 #include <numeric>
-#include "gurobi_c++.h"
+#include <chrono>
+#include <omp.h>
+#include <cstdint>
+
+#include "../../common/fast_reader.h"
+#include "../../common/fast_writer.h"
+#include "../../common/instance_cache.h"
+#include "../../common/run_control.h"
 
 using namespace std;
 
@@ -37,12 +44,24 @@ struct Book{
     ll score;
 };
 
+// a library's part of library_books
+struct book_list{
+    int* first = nullptr;
+    int n = 0;
+    int* begin() const { return first; }
+    int* end() const { return first + n; }
+    size_t size() const { return n; }
+    int& operator[](size_t i) const { return first[i]; }
+};
+
 struct Library{
     ll id;
     ll sign_up_time;
     ll books_per_day;
     bool signed_up = false;
-    vector<int> books;
+    book_list books; // sorted by decreasing score
+    int offset; // position of books[0] in library_books
+    int cursor = 0; // books[0, cursor) are all used already
     vector<int> books_for_scan;
     double cur_score = 0;
 };
@@ -52,7 +71,252 @@ vector<Library> libraries;
 
 //
 vector<int> library_queue;
-vector<bool> used_book;
+
+// book lists of all libraries back to back. the slots of a library are
+// contiguous and sorted by decreasing score, slot_score holds the scores in
+// the same layout and slot_used has bit k set if library_books[k] is used,
+// so scoring a library is one pass over contiguous memory
+vector<int> library_books; // empty when loaded from the cache
+vector<ll> slot_score;
+vector<uint64_t> slot_used;
+vector<uint64_t> used_book; // bit b set if book b is used
+// libraries having book b: book_libs[book_lib_begin[b], book_lib_begin[b+1]),
+// book_slots holds the position of b in library_books for each of them
+vector<int> book_lib_begin, book_libs, book_slots;
+
+bool is_used(int b){
+  return (used_book[b >> 6] >> (b & 63)) & 1;
+}
+
+void set_used(int b){
+  used_book[b >> 6] |= uint64_t(1) << (b & 63);
+  rep(k, book_lib_begin[b], book_lib_begin[b + 1]) slot_used[book_slots[k] >> 6] |= uint64_t(1) << (book_slots[k] & 63);
+}
+
+double search_seconds = 30.0; // time budget of the library order search
+double time_limit = 0; // wall-clock budget of the whole run in seconds, 0 = none
+int search_batch = 64; // moves evaluated per thread before the best is applied
+int search_window = 10; // max distance of swapped or moved libraries
+
+// true if book a comes before book b in the sorted book lists
+bool ranks_before(int a, int b){
+  if (books[a].score == books[b].score) return a < b;
+  return books[a].score > books[b].score;
+}
+
+// a change of the library order: swap positions i and j, move the library
+// at i to position j, or replace the library at i by the unsigned library u
+struct order_move{
+  int type, i, j;
+};
+
+// greedy book assignment for a library order: every library takes its best
+// books that are not taken by an earlier library, up to its capacity. after
+// a move only the affected libraries are touched, in order of position:
+// moved libraries are rescanned, libraries with a changed capacity or a book
+// lost to an earlier library are repaired at the end of their book list, and
+// a book that becomes free goes directly to the first library that wants it
+// (which may push out its last book). the result equals the full greedy.
+struct order_state{
+  vector<int> order; // signed up libraries
+  vector<int> pos; // position in order, -1 if not signed up
+  vector<ll> cap; // number of books a library can scan
+  vector<int> owner; // library scanning a book, -1 if none
+  vector<int> taken; // number of books a library scans
+  vector<int> last; // lowest ranked book a library scans, -1 if none
+  vector<bool> is_dirty, need_rescan;
+  priority_queue<pi, vector<pi>, greater<pi> > dirty; // (position, library)
+  ll score = 0;
+
+  void init(vector<int>& queue){
+    order = queue;
+    pos.assign(L, -1);
+    cap.assign(L, 0);
+    owner.assign(B, -1);
+    taken.assign(L, 0);
+    last.assign(L, -1);
+    is_dirty.assign(L, false);
+    need_rescan.assign(L, false);
+    score = 0;
+    rep(i, 0, sz(order)) pos[order[i]] = i;
+    trav(l, order) mark_rescan(l);
+    update_caps(0);
+    evaluate();
+  }
+
+  void mark(int l){
+    if (is_dirty[l]) return;
+    is_dirty[l] = true;
+    dirty.push({pos[l], l});
+  }
+
+  void mark_rescan(int l){
+    need_rescan[l] = true;
+    mark(l);
+  }
+
+  // recomputes capacities from position p on, libraries with a changed
+  // capacity are marked
+  void update_caps(int p){
+    ll day = 0;
+    rep(i, 0, p) day += libraries[order[i]].sign_up_time;
+    rep(i, p, sz(order)){
+      Library& l = libraries[order[i]];
+      day += l.sign_up_time;
+      ll c = max(0LL, min((D - day) * l.books_per_day, (ll) sz(l.books)));
+      if (c != cap[l.id]){
+        cap[l.id] = c;
+        mark(l.id);
+      }
+    }
+  }
+
+  int index_of(int l, int b){
+    book_list& bk = libraries[l].books;
+    return lower_bound(all(bk), b, ranks_before) - bk.begin();
+  }
+
+  // last book scanned by l at or before index idx of its list, -1 if none
+  int owned_before(int l, int idx){
+    book_list& bk = libraries[l].books;
+    while (idx >= 0 && owner[bk[idx]] != l) idx--;
+    return idx < 0 ? -1 : bk[idx];
+  }
+
+  // l takes book b, which is free or scanned by a later library
+  void take(int l, int b){
+    int o = owner[b];
+    owner[b] = l;
+    if (o == -1) score += books[b].score;
+    else {
+      taken[o]--;
+      if (last[o] == b) last[o] = owned_before(o, index_of(o, b) - 1);
+      mark(o);
+    }
+    taken[l]++;
+    if (last[l] == -1 || ranks_before(last[l], b)) last[l] = b;
+  }
+
+  // l at position p gives up book b
+  void drop(int l, int b, int p){
+    owner[b] = -1;
+    score -= books[b].score;
+    taken[l]--;
+    if (last[l] == b) last[l] = owned_before(l, index_of(l, b) - 1);
+    release(b, p);
+  }
+
+  // free book b goes to the first library after position p that wants it.
+  // a library waiting for its repair may still miss better books than b, so
+  // it only wants b if b ranks before its last book
+  void release(int b, int p){
+    int taker = -1;
+    rep(k, book_lib_begin[b], book_lib_begin[b + 1]){
+      int l = book_libs[k];
+      if (pos[l] <= p || need_rescan[l] || cap[l] == 0) continue;
+      if (taker != -1 && pos[l] > pos[taker]) continue;
+      if ((taken[l] < cap[l] && !is_dirty[l]) || (last[l] != -1 && ranks_before(b, last[l]))) taker = l;
+    }
+    if (taker == -1) return;
+    take(taker, b);
+    while (taken[taker] > cap[taker]) drop(taker, last[taker], pos[taker]);
+  }
+
+  // gives up all books of library l before it moves. l must be marked for a
+  // rescan or unsigned so that it does not take them back
+  void free_all(int l){
+    trav(b, libraries[l].books){
+      if (owner[b] != l) continue;
+      owner[b] = -1;
+      score -= books[b].score;
+      release(b, -1);
+    }
+    taken[l] = 0;
+    last[l] = -1;
+  }
+
+  void rescan(int l){
+    need_rescan[l] = false;
+    int p = pos[l];
+    book_list& bk = libraries[l].books;
+    int cnt = 0;
+    rep(idx, 0, sz(bk)){
+      if (cnt == cap[l] && taken[l] == cnt) break;
+      int b = bk[idx];
+      int o = owner[b];
+      if (cnt < cap[l] && (o == l || o == -1 || pos[o] > p)){
+        if (o != l) take(l, b);
+        cnt++;
+      }
+      else if (o == l) drop(l, b, p);
+    }
+  }
+
+  // the books of l are a correct prefix of its greedy choice, up to a changed
+  // capacity or books lost to earlier libraries
+  void repair(int l){
+    int p = pos[l];
+    while (taken[l] > cap[l]) drop(l, last[l], p);
+    if (taken[l] == cap[l]) return;
+    book_list& bk = libraries[l].books;
+    for (int idx = last[l] == -1 ? 0 : index_of(l, last[l]) + 1; idx < sz(bk) && taken[l] < cap[l]; idx++){
+      int o = owner[bk[idx]];
+      if (o == -1 || pos[o] > p) take(l, bk[idx]);
+    }
+  }
+
+  void evaluate(){
+    while (!dirty.empty()){
+      int l = dirty.top().se;
+      dirty.pop();
+      is_dirty[l] = false;
+      if (need_rescan[l]) rescan(l);
+      else repair(l);
+    }
+  }
+
+  // positions are updated before anything is marked, so the queue of dirty
+  // libraries always holds current positions
+  void apply(order_move m){
+    if (m.type == 0){
+      int a = order[m.i], b = order[m.j];
+      swap(order[m.i], order[m.j]);
+      pos[a] = m.j;
+      pos[b] = m.i;
+      mark_rescan(a);
+      mark_rescan(b);
+      free_all(a);
+      free_all(b);
+      update_caps(min(m.i, m.j));
+    }
+    else if (m.type == 1){
+      int a = order[m.i];
+      if (m.i < m.j) rotate(order.begin() + m.i, order.begin() + m.i + 1, order.begin() + m.j + 1);
+      else rotate(order.begin() + m.j, order.begin() + m.i, order.begin() + m.i + 1);
+      rep(k, min(m.i, m.j), max(m.i, m.j) + 1) pos[order[k]] = k;
+      mark_rescan(a);
+      free_all(a);
+      update_caps(min(m.i, m.j));
+    }
+    else {
+      int a = order[m.i];
+      pos[a] = -1;
+      cap[a] = 0;
+      order[m.i] = m.j;
+      pos[m.j] = m.i;
+      free_all(a);
+      mark_rescan(m.j);
+      update_caps(m.i);
+    }
+    evaluate();
+  }
+
+  // the move that undoes m, to be taken before m is applied
+  order_move inverse(order_move m){
+    if (m.type == 2) return {2, m.i, order[m.i]};
+    return {m.type, m.j, m.i};
+  }
+};
 
 struct instance{
 
@@ -61,24 +325,94 @@ struct instance{
   // stores the respective objects
 
   // read instance
-  void read(){
-    cin >> B >> L >> D;
+  void read(fast_reader &in){
+    in >> B >> L >> D;
     books.resize(B);
-    used_book.resize(B);
+    used_book.assign(B / 64 + 1, 0);
     rep(i, 0, B){
       books[i].id = i;
-      cin >> books[i].score;
+      in >> books[i].score;
     }
     libraries.resize(L);
     int b;
     rep(i, 0, L) {
       libraries[i].id = i;
-      cin >> b;
-      libraries[i].books.resize(b);
-      cin >> libraries[i].sign_up_time >> libraries[i].books_per_day;
-      rep(j, 0, b) cin >> libraries[i].books[j];
+      in >> b;
+      libraries[i].offset = sz(library_books);
+      libraries[i].books.n = b;
+      in >> libraries[i].sign_up_time >> libraries[i].books_per_day;
+      library_books.resize(library_books.size() + b);
+      rep(j, 0, b) in >> library_books[libraries[i].offset + j];
+    }
+    trav(l, libraries){
+      l.books.first = library_books.data() + l.offset;
+      sort(all(l.books), ranks_before);
+    }
+    int S = sz(library_books);
+    slot_score.resize(S);
+    rep(k, 0, S) slot_score[k] = books[library_books[k]].score;
+    slot_used.assign(S / 64 + 1, 0);
+
+    book_lib_begin.assign(B + 1, 0);
+    trav(bid, library_books) book_lib_begin[bid + 1]++;
+    rep(b, 0, B) book_lib_begin[b + 1] += book_lib_begin[b];
+    book_libs.resize(S);
+    book_slots.resize(S);
+    vector<int> fill(all(book_lib_begin));
+    trav(l, libraries) rep(j, 0, sz(l.books)){
+      int bid = l.books[j];
+      book_libs[fill[bid]] = l.id;
+      book_slots[fill[bid]++] = l.offset + j;
+    }
+
+  }
+
+  // instance cache: everything read() builds. the book lists point into the
+  // mapping, the slot and book arrays are copied since they are globals
+  void save(cache_writer &snapshot){
+    ll header[3] = {B, L, D};
+    snapshot.put(header, 3);
+    snapshot.put(books);
+    vector<ll> lib;
+    trav(l, libraries){
+      lib.pb(l.sign_up_time);
+      lib.pb(l.books_per_day);
+      lib.pb(l.books.size());
     }
+    snapshot.put(lib);
+    snapshot.put(library_books);
+    snapshot.put(slot_score);
+    snapshot.put(book_lib_begin);
+    snapshot.put(book_libs);
+    snapshot.put(book_slots);
+  }
 
+  void load(cache_reader &snapshot){
+    size_t n;
+    const ll* header = snapshot.view<ll>(n);
+    B = header[0]; L = header[1]; D = header[2];
+    snapshot.get(books);
+    used_book.assign(B / 64 + 1, 0);
+    const ll* lib = snapshot.view<ll>(n);
+    int* slots = snapshot.view<int>(n);
+    int S = n;
+    libraries.resize(L);
+    int offset = 0;
+    rep(i, 0, L){
+      Library &l = libraries[i];
+      l.id = i;
+      l.sign_up_time = lib[3 * i];
+      l.books_per_day = lib[3 * i + 1];
+      l.offset = offset;
+      l.books.first = slots + offset;
+      l.books.n = lib[3 * i + 2];
+      offset += l.books.n;
+    }
+    snapshot.get(slot_score);
+    slot_used.assign(S / 64 + 1, 0);
+    snapshot.get(book_lib_begin);
+    snapshot.get(book_libs);
+    snapshot.get(book_slots);
   }
 
   void get_upper_bound(){
@@ -87,157 +421,253 @@ struct instance{
     cerr << "upper bound: " << ret << endl;
   }
 
-  int get_best_library(int day){
-
-    int ret = -1;
-    double best_score = 0;
-    trav(l, libraries){
-      if (l.signed_up) continue;
-      sort(all(l.books), [](const auto& a, const auto& b){if (used_book[a] == used_book[b]) return books[a].score > books[b].score; else return used_book[a] < used_book[b]; });
-      int rem_books = (D - day - l.sign_up_time) * l.books_per_day;
-
-      l.cur_score = 0;
-
-      rep(i, 0, min(sz(l.books), rem_books)){
-        if (!used_book[l.books[i]]) {
-          l.cur_score += books[l.books[i]].score;
-        }
+  // score of the best unused books library l can still scan when signing up
+  // at day, per sign up day
+  // unused slots are taken 64 at a time from the usage bitmap; completely
+  // unused words are summed as a plain contiguous loop
+  double get_library_score(Library& l, int day){
+    ll rem_books = (D - day - l.sign_up_time) * l.books_per_day;
+    int lo = l.offset, hi = l.offset + sz(l.books);
+    while (lo + l.cursor < hi && ((slot_used[(lo + l.cursor) >> 6] >> ((lo + l.cursor) & 63)) & 1)) l.cursor++;
+    ll sum = 0;
+    for (int k = lo + l.cursor; k < hi && rem_books > 0; k = (k | 63) + 1){
+      int w = k >> 6;
+      uint64_t free_bits = ~slot_used[w] & (~uint64_t(0) << (k & 63));
+      if (hi - (w << 6) < 64) free_bits &= (uint64_t(1) << (hi - (w << 6))) - 1;
+      int c = __builtin_popcountll(free_bits);
+      if (c == 64 && rem_books >= 64){
+        ll* sc = slot_score.data() + (w << 6);
+        rep(j, 0, 64) sum += sc[j];
+        rem_books -= 64;
+        continue;
       }
-
-      l.cur_score = l.cur_score / l.sign_up_time;
-
-      if (l.cur_score > best_score){
-        best_score = l.cur_score;
-        ret = l.id;
+      if (c > rem_books) c = rem_books;
+      rem_books -= c;
+      while (c-- > 0){
+        sum += slot_score[(w << 6) + __builtin_ctzll(free_bits)];
+        free_bits &= free_bits - 1;
       }
-
     }
-    return ret;
+    l.cur_score = double(sum) / l.sign_up_time;
+    return l.cur_score;
   }
 
   bool assign_library_books(int lid, int day){
     Library& l = libraries[lid];
 
-    sort(all(l.books), [](const auto& a, const auto& b){if (used_book[a] == used_book[b]) return books[a].score > books[b].score; else return used_book[a] < used_book[b]; });
-
-    int nbr_books = (D - day - l.sign_up_time) * l.books_per_day;
+    ll nbr_books = (D - day - l.sign_up_time) * l.books_per_day;
 
-    vector<int>& tmpbooks = l.books;
-    rep(i, 0, min(nbr_books, sz(tmpbooks))){
-      if (used_book[tmpbooks[i]]) break;
-      used_book[tmpbooks[i]] = true;
-      l.books_for_scan.pb(tmpbooks[i]);
-      instance_score += books[tmpbooks[i]].score;
+    for (int i = l.cursor; i < sz(l.books) && nbr_books > 0; i++){
+      int bid = l.books[i];
+      if (is_used(bid)) continue;
+      set_used(bid);
+      l.books_for_scan.pb(bid);
+      instance_score += books[bid].score;
+      nbr_books--;
     }
     if (sz(libraries[lid].books_for_scan) > 0) return true;
     else return false;
   }
 
-  int get_ip_solution(){
-    GRBEnv env;
-    GRBModel m = GRBModel(env);
-    m.getEnv().set("OutputFlag", "1");
-    m.getEnv().set("TimeLimit", "10.0");
-    m.getEnv().set("MIPgap", "0");
-    //m.getEnv().set("ModelSense","-1");
-
-    vector<map<int, GRBVar> > x(L); //
-
-    trav(l, libraries){
-        trav(bid, l.books){
-          x[l.id][bid] = m.addVar(0, 1, 0, GRB_BINARY);
-        }
-    }
-
-    m.update();
-
-    // add library constraints
-    int rem_days = D;
-    for (int lid: library_queue){
-
-      Library& l = libraries[lid];
+  // optimal book assignment for the fixed order in library_queue: every
+  // book at most once, library l scans at most (days left after its sign up)
+  // * books_per_day books. since the weights sit on the books only, adding
+  // books greedily by decreasing score is optimal (the feasible book sets
+  // form a transversal matroid); a book is added if an augmenting path to a
+  // library with spare capacity exists, possibly moving other books between
+  // libraries. if the search fails, all libraries it visited are full and
+  // every book in them can only go to libraries of that set, so they are
+  // never searched again.
+  ll get_flow_solution(){
+    int n = sz(library_queue);
+
+    // capacities in queue order
+    vector<ll> cap(n), load(n, 0);
+    vector<int> pos(L, -1); // position of a library in the queue
+    ll rem_days = D;
+    rep(i, 0, n){
+      Library& l = libraries[library_queue[i]];
       rem_days -= l.sign_up_time;
-      GRBLinExpr expr = 0;
-      trav(bid, l.books){
-        expr += x[lid][bid];
-      }
-
-      m.addConstr(expr <= rem_days * l.books_per_day);
-      m.addConstr(expr <= sz(l.books));
+      cap[i] = max(0LL, min(rem_days * l.books_per_day, (ll) sz(l.books)));
+      pos[l.id] = i;
     }
 
-    // add objective constraints
-    vector<vector<int> > books_to_libraries(B);
-
-    trav(lid, library_queue){
-      Library& l = libraries[lid];
-      trav(bid, l.books) books_to_libraries[bid].pb(l.id);
+    vector<int> order;
+    rep(b, 0, B) rep(k, book_lib_begin[b], book_lib_begin[b + 1]) if (pos[book_libs[k]] != -1){
+      order.pb(b);
+      break;
     }
-
-    GRBLinExpr obj = 0;
-
-    rep(bid, 0, B){
-      GRBLinExpr expr2 = 0;
-      trav(lid, books_to_libraries[bid]) {
-        expr2 += x[lid][bid];
-        obj += x[lid][bid] * books[bid].score;
+    sort(all(order), ranks_before);
+
+    vector<int> owner(B, -1); // queue position of the library scanning the book
+    vector<int> via(n); // book that moves into the library on the search path
+    vector<int> visited(n, -1); // stamp of the last search
+    vector<bool> dead(n, false);
+    vector<int> bfs;
+    ll score = 0;
+
+    for (int b0: order){
+      bfs.clear();
+      int found = -1;
+      rep(k, book_lib_begin[b0], book_lib_begin[b0 + 1]){
+        int l = pos[book_libs[k]];
+        if (l == -1 || dead[l] || cap[l] == 0 || visited[l] == b0) continue;
+        visited[l] = b0;
+        via[l] = b0;
+        if (load[l] < cap[l]){ found = l; break; }
+        bfs.pb(l);
       }
-      m.addConstr(expr2 <= 1);
-    }
-
-    m.setObjective(obj, GRB_MAXIMIZE);
-
-    m.optimize();
-
-    // retrieve assignment
-    int score = 0;
-
-    trav(lid, library_queue){
-      libraries[lid].books_for_scan.clear();
-      trav(bid, libraries[lid].books){
-        if (x[lid][bid].get(GRB_DoubleAttr_X) > 0.5){
-          libraries[lid].books_for_scan.pb(bid);
-          score += books[bid].score;
+      for (int h = 0; found == -1 && h < sz(bfs); h++){
+        int l = bfs[h];
+        trav(bid, libraries[library_queue[l]].books){
+          if (owner[bid] != l) continue;
+          rep(k, book_lib_begin[bid], book_lib_begin[bid + 1]){
+            int l2 = pos[book_libs[k]];
+            if (l2 == -1 || dead[l2] || cap[l2] == 0 || visited[l2] == b0) continue;
+            visited[l2] = b0;
+            via[l2] = bid;
+            if (load[l2] < cap[l2]){ found = l2; break; }
+            bfs.pb(l2);
+          }
+          if (found != -1) break;
         }
       }
+
+      if (found == -1){
+        trav(l, bfs) dead[l] = true;
+        continue;
+      }
+      // shift the books along the path
+      load[found]++;
+      int l = found;
+      while (true){
+        int bid = via[l];
+        int from = owner[bid];
+        owner[bid] = l;
+        if (bid == b0) break;
+        l = from;
+      }
+      score += books[b0].score;
     }
 
+    trav(lid, library_queue) libraries[lid].books_for_scan.clear();
+    rep(b, 0, B) if (owner[b] != -1) libraries[library_queue[owner[b]]].books_for_scan.pb(b);
     return score;
-
   }
 
+  // greedy sign up order. library scores only decrease over time (fewer days
+  // left, more books used), so a lazy priority queue suffices: a popped entry
+  // that was computed before the last sign up is recomputed and pushed back,
+  // an up-to-date entry on top is the best library.
   void solve(){
 
     int day = 0;
+    int version = 0; // number of sign ups so far
 
-    while (day <= D){
-      int best = get_best_library(day);
-      if (best == -1) break;
-      libraries[best].signed_up = true;
-      if (assign_library_books(best, day)){
-        library_queue.pb(best);
+    // (score, -library id, version the score was computed at)
+    priority_queue<tuple<double, int, int> > queue;
+    trav(l, libraries){
+      double sc = get_library_score(l, day);
+      if (sc > 0) queue.push(make_tuple(sc, -l.id, version));
+    }
+
+    while (day <= D && !queue.empty() && !run_control::stopped()){
+      double sc; int lid, ver;
+      tie(sc, lid, ver) = queue.top(); queue.pop();
+      lid = -lid;
+      if (ver != version){
+        sc = get_library_score(libraries[lid], day);
+        if (sc > 0) queue.push(make_tuple(sc, -lid, version));
+        continue;
+      }
+      libraries[lid].signed_up = true;
+      if (assign_library_books(lid, day)){
+        library_queue.pb(lid);
       }
-      day += libraries[best].sign_up_time;
+      day += libraries[lid].sign_up_time;
+      version++;
     }
 
   }
 
-  void write() {
+  // local search over the order in library_queue with swap, move and
+  // replace moves. every thread keeps its own order_state; in each round all
+  // threads evaluate search_batch random moves (apply, evaluate, undo) and the
+  // best improving move is applied to all states.
+  void local_search(double seconds){
+    if (library_queue.empty()) return;
+    auto start = chrono::steady_clock::now();
+    int T = omp_get_max_threads();
+    vector<order_state> states(T);
+    states[0].init(library_queue);
+    rep(t, 1, T) states[t] = states[0];
+    ll initial = states[0].score;
+
+    vector<int> unsigned_libraries;
+    trav(l, libraries) if (states[0].pos[l.id] == -1) unsigned_libraries.pb(l.id);
+
+    vector<pair<ll, order_move> > best(T);
+    for (int round = 0; chrono::duration<double>(chrono::steady_clock::now() - start).count() < seconds && !run_control::stopped(); round++){
+      #pragma omp parallel num_threads(T)
+      {
+        int t = omp_get_thread_num();
+        order_state& st = states[t];
+        mt19937 rng(round * T + t);
+        int n = sz(st.order);
+        best[t] = {0, {0, 0, 0}};
+        rep(k, 0, search_batch){
+          // nearby positions keep the number of changed capacities small
+          int type = rng() % 3;
+          int i = rng() % n;
+          int j = min(n - 1, max(0, i + int(rng() % (2 * search_window + 1)) - search_window));
+          order_move m = {type, i, j};
+          if (type == 2){
+            if (unsigned_libraries.empty()) continue;
+            m.j = unsigned_libraries[rng() % sz(unsigned_libraries)];
+            if (st.pos[m.j] != -1) continue;
+          }
+          else if (m.i == m.j) continue;
+          order_move undo = st.inverse(m);
+          ll old_score = st.score;
+          st.apply(m);
+          ll delta = st.score - old_score;
+          if (delta > best[t].fi) best[t] = {delta, m};
+          st.apply(undo);
+        }
+      }
+      int bt = 0;
+      rep(t, 1, T) if (best[t].fi > best[bt].fi) bt = t;
+      if (best[bt].fi <= 0) continue;
+      order_move m = best[bt].se;
+      if (m.type == 2){
+        int removed = states[0].order[m.i];
+        replace(all(unsigned_libraries), (int) m.j, removed);
+      }
+      #pragma omp parallel for num_threads(T)
+      for (int t = 0; t < T; t++) states[t].apply(m);
+    }
+    cerr << "order search: " << initial << " -> " << states[0].score << endl;
+    library_queue = states[0].order;
+  }
+
+  void write(fast_writer &os) {
     int cnt = 0;
     for (int lid : library_queue){
       if (libraries[lid].books_for_scan.size() > 0) cnt++;
     }
-    cout << cnt << endl;
+    os << cnt << '\n';
 
     trav(lid, library_queue){
       if (libraries[lid].books_for_scan.size() == 0) continue;
-      cout << lid << " " << libraries[lid].books_for_scan.size() << endl;
-      print(libraries[lid].books_for_scan);
+      os << lid << ' ' << libraries[lid].books_for_scan.size() << '\n';
+      trav(b, libraries[lid].books_for_scan) os << b << ' ';
+      os << '\n';
     }
   }
 
 };
 
+#ifndef NO_MAIN // the kernel benchmarks in bench/ include this file
 instance I;
 int main(int argc, char* argv[]){
 
@@ -245,13 +675,15 @@ int main(int argc, char* argv[]){
   cin.tie(0);
   string input_file = argv[1];
   srand(time(NULL));
-  freopen(input_file.c_str(), "r", stdin); // redirects standard input
-  I.read();
+  run_control::start(time_limit);
+  read_instance(I, input_file, "2020-quali", 1);
   I.get_upper_bound();
   I.solve();
-  int best_score = I.get_ip_solution();
+  I.local_search(search_seconds);
+  ll best_score = I.get_flow_solution();
   string output_file = input_file + "out" + to_string(best_score);
-  freopen(output_file.c_str(), "w", stdout); // redirects standard output
-  I.write();
+  fast_writer os(output_file.c_str());
+  I.write(os);
 
 }
+#endif
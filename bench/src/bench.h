@@ -0,0 +1,38 @@
+/*
+  Helpers for the kernel benchmarks. A kernel is run repeatedly until it has
+  taken at least min_seconds, then calls/s, work units/s and the peak
+  resident memory of the process are printed as one line.
+*/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <sys/resource.h>
+
+double min_seconds = 2.0; // per kernel, can be set with the second argument
+
+// peak resident set size of this process in MB
+inline double peak_rss_mb(){
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_maxrss / 1024.0; // kilobytes on linux
+}
+
+// f() runs the kernel batch times and returns the work units it processed
+template<class F> void measure(const char *name, const char *unit, F f, int batch = 1){
+  auto start = std::chrono::steady_clock::now();
+  long long calls = 0;
+  double work = 0, elapsed = 0;
+  do {
+    work += f();
+    calls += batch;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  } while (elapsed < min_seconds);
+  printf("%-28s %10lld calls %10.3f s %14.1f calls/s %14.1f %s/s %8.1f MB peak\n",
+    name, calls, elapsed, calls / elapsed, work / elapsed, unit, peak_rss_mb());
+  fflush(stdout);
+}
+
+#endif
@@ -0,0 +1,259 @@
+/*
+  Synthetic instance generators for all problems in this repo.
+
+  Usage:  ./gen <problem> <output file> [key=value ...]
+  e.g.    ./gen 2018-quali ../work/a.in N=10000 F=300 seed=2
+
+  Every problem has a few size and shape parameters (see the defaults in
+  the generators below, unknown keys are rejected). The same parameters and
+  seed always give the same file.
+*/
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+#include "../../common/fast_writer.h"
+
+using namespace std;
+
+#define rep(i, from, to) for (ll i = from; i < ll(to); ++i)
+#define trav(a, x) for (auto& a : x)
+#define all(x) x.begin(), x.end()
+#define sz(x) (ll)(x).size()
+#define pb push_back
+#define fi first
+#define se second
+
+typedef long long ll;
+
+// key=value arguments with defaults
+struct params{
+  map<string, double> values;
+  set<string> used;
+
+  double get(const string &key, double def){
+    used.insert(key);
+    auto it = values.find(key);
+    return it == values.end() ? def : it->second;
+  }
+  ll operator()(const string &key, ll def){ return (ll) get(key, def); }
+
+  // keys given on the command line that no generator asked for
+  bool check(){
+    bool ok = true;
+    trav(kv, values) if (!used.count(kv.fi)) {
+      cerr << "unknown parameter " << kv.fi << endl;
+      ok = false;
+    }
+    return ok;
+  }
+};
+
+mt19937_64 rng;
+
+ll uniform(ll lo, ll hi){ // [lo, hi]
+  return uniform_int_distribution<ll>(lo, hi)(rng);
+}
+
+double uniform01(){
+  return uniform_real_distribution<double>(0, 1)(rng);
+}
+
+// k distinct values out of [0, n)
+vector<ll> sample(ll n, ll k){
+  k = min(k, n);
+  vector<ll> ret;
+  if (k * 4 > n){
+    vector<ll> v(n);
+    rep(i, 0, n) v[i] = i;
+    rep(i, 0, k) swap(v[i], v[uniform(i, n - 1)]);
+    ret.assign(v.begin(), v.begin() + k);
+  }
+  else {
+    set<ll> s;
+    while (sz(s) < k) s.insert(uniform(0, n - 1));
+    ret.assign(all(s));
+    shuffle(all(ret), rng);
+  }
+  return ret;
+}
+
+// pizza grid: R x C, share of mushrooms in percent
+void gen_warmup(params &p, fast_writer &os){
+  ll R = p("R", 1000), C = p("C", 1000), L = p("L", 6), H = p("H", 14);
+  double mushrooms = p.get("mushrooms", 50) / 100.0;
+  os << R << ' ' << C << ' ' << L << ' ' << H << '\n';
+  string row(C, 'T');
+  rep(r, 0, R){
+    rep(c, 0, C) row[c] = uniform01() < mushrooms ? 'M' : 'T';
+    os << row << '\n';
+  }
+}
+
+// street graph: random spanning tree plus random extra streets. the solver
+// starts all cars at node 4516, so N has to be larger than that
+void gen_2014(params &p, fast_writer &os){
+  ll N = p("N", 11348), M = p("M", 17958), T = p("T", 54000), C = p("C", 8), S = p("S", 4516);
+  double two_way = p.get("two_way", 67) / 100.0;
+  if (S >= N){
+    cerr << "S has to be smaller than N" << endl;
+    exit(1);
+  }
+  M = max(M, N - 1);
+  os << N << ' ' << M << ' ' << T << ' ' << C << ' ' << S << '\n';
+  char buf[64];
+  rep(i, 0, N){
+    snprintf(buf, sizeof(buf), "%.7f %.7f\n", 48.8 + uniform01() * 0.1, 2.2 + uniform01() * 0.2);
+    os << buf;
+  }
+  set<pair<ll, ll> > edges;
+  auto add = [&](ll a, ll b){
+    if (a == b || edges.count({a, b}) || edges.count({b, a})) return;
+    edges.insert({a, b});
+    os << a << ' ' << b << ' ' << (uniform01() < two_way ? 2 : 1) << ' ' << uniform(1, 100) << ' ' << uniform(10, 1000) << '\n';
+  };
+  rep(i, 1, N) add(uniform(0, i - 1), i);
+  while (sz(edges) < M) add(uniform(0, N - 1), uniform(0, N - 1));
+}
+
+// data center: R rows of C slots, U unavailable slots, P pools, M servers
+void gen_2015(params &p, fast_writer &os){
+  ll R = p("R", 16), C = p("C", 100), U = p("U", 80), P = p("P", 45), M = p("M", 625);
+  ll max_size = p("max_size", 5), max_cap = p("max_cap", 100);
+  U = min(U, R * C);
+  os << R << ' ' << C << ' ' << U << ' ' << P << ' ' << M << '\n';
+  trav(s, sample(R * C, U)) os << s / C << ' ' << s % C << '\n';
+  rep(i, 0, M) os << uniform(1, max_size) << ' ' << uniform(1, max_cap) << '\n';
+}
+
+// drone delivery: P products, W warehouses, O orders of up to max_items items
+void gen_2016(params &p, fast_writer &os){
+  ll R = p("R", 400), C = p("C", 600), D = p("D", 30), T = p("T", 112993), M = p("M", 200);
+  ll P = p("P", 400), W = p("W", 10), O = p("O", 1250);
+  ll max_weight = p("max_weight", 150), max_stock = p("max_stock", 10), max_items = p("max_items", 15);
+  os << R << ' ' << C << ' ' << D << ' ' << T << ' ' << M << '\n' << P << '\n';
+  rep(i, 0, P) os << uniform(1, min(max_weight, M)) << (i + 1 < P ? ' ' : '\n');
+  os << W << '\n';
+  rep(w, 0, W){
+    os << uniform(0, R - 1) << ' ' << uniform(0, C - 1) << '\n';
+    rep(i, 0, P) os << uniform(0, max_stock) << (i + 1 < P ? ' ' : '\n');
+  }
+  os << O << '\n';
+  rep(o, 0, O){
+    ll n = uniform(1, max_items);
+    os << uniform(0, R - 1) << ' ' << uniform(0, C - 1) << '\n' << n << '\n';
+    rep(i, 0, n) os << uniform(0, P - 1) << (i + 1 < n ? ' ' : '\n');
+  }
+}
+
+// streaming videos: V videos, E endpoints with up to K cache connections, R request lines
+void gen_2017(params &p, fast_writer &os){
+  ll V = p("V", 1000), E = p("E", 100), R = p("R", 20000), C = p("C", 50), X = p("X", 6000);
+  ll K = p("K", 10), max_size = p("max_size", 700);
+  os << V << ' ' << E << ' ' << R << ' ' << C << ' ' << X << '\n';
+  rep(i, 0, V) os << uniform(1, max_size) << (i + 1 < V ? ' ' : '\n');
+  rep(e, 0, E){
+    ll latency = uniform(200, 1500);
+    vector<ll> caches = sample(C, uniform(0, K));
+    os << latency << ' ' << sz(caches) << '\n';
+    trav(c, caches) os << c << ' ' << uniform(10, latency - 1) << '\n';
+  }
+  // (video, endpoint) pairs must be unique
+  set<pair<ll, ll> > seen;
+  R = min(R, V * E);
+  while (sz(seen) < R){
+    ll v = uniform(0, V - 1), e = uniform(0, E - 1);
+    if (!seen.insert({v, e}).second) continue;
+    os << v << ' ' << e << ' ' << uniform(1, 1000) << '\n';
+  }
+}
+
+// self-driving rides: F vehicles, N rides on an R x C grid, bonus B, T steps
+void gen_2018(params &p, fast_writer &os){
+  ll R = p("R", 200), C = p("C", 200), F = p("F", 30), N = p("N", 1000), B = p("B", 10), T = p("T", 5000);
+  os << R << ' ' << C << ' ' << F << ' ' << N << ' ' << B << ' ' << T << '\n';
+  rep(i, 0, N){
+    ll a = uniform(0, R - 1), b = uniform(0, C - 1), x = uniform(0, R - 1), y = uniform(0, C - 1);
+    ll s = uniform(0, T / 2 - 1), f = min(T, s + abs(a - x) + abs(b - y) + uniform(1, T / 2 - 1));
+    os << a << ' ' << b << ' ' << x << ' ' << y << ' ' << s << ' ' << f << '\n';
+  }
+}
+
+// photo slideshow: N photos, tags drawn from a pool of size tags. skew > 1
+// makes low tag ids more frequent (a few very common tags, a long tail)
+void gen_2019(params &p, fast_writer &os){
+  ll N = p("N", 80000), tags = p("tags", 50000), min_tags = p("min_tags", 2), max_tags = p("max_tags", 20);
+  double vertical = p.get("vertical", 50) / 100.0, skew = p.get("skew", 2);
+  os << N << '\n';
+  vector<ll> t;
+  rep(i, 0, N){
+    ll k = min(uniform(min_tags, max_tags), tags);
+    t.clear();
+    while (sz(t) < k){
+      ll x = min(tags - 1, (ll) (tags * pow(uniform01(), skew)));
+      if (find(all(t), x) == t.end()) t.pb(x);
+    }
+    os << (uniform01() < vertical ? 'V' : 'H') << ' ' << k;
+    trav(x, t) os << " t" << x;
+    os << '\n';
+  }
+}
+
+// more pizza: N pizza types with up to max_pieces slices, order at most M slices
+void gen_2020_practice(params &p, fast_writer &os){
+  ll M = p("M", 1000000), N = p("N", 2000), max_pieces = p("max_pieces", 1000);
+  vector<ll> pieces(N);
+  trav(x, pieces) x = uniform(1, max_pieces);
+  sort(all(pieces));
+  os << M << ' ' << N << '\n';
+  rep(i, 0, N) os << pieces[i] << (i + 1 < N ? ' ' : '\n');
+}
+
+// book scanning: B books, L libraries with up to max_books books, D days
+void gen_2020_quali(params &p, fast_writer &os){
+  ll B = p("B", 100000), L = p("L", 1000), D = p("D", 1000), max_books = p("max_books", 1000);
+  ll max_score = p("max_score", 300), max_signup = p("max_signup", 10), max_rate = p("max_rate", 5);
+  os << B << ' ' << L << ' ' << D << '\n';
+  rep(i, 0, B) os << uniform(1, max_score) << (i + 1 < B ? ' ' : '\n');
+  rep(l, 0, L){
+    vector<ll> books = sample(B, uniform(1, max_books));
+    os << sz(books) << ' ' << uniform(1, max_signup) << ' ' << uniform(1, max_rate) << '\n';
+    rep(i, 0, sz(books)) os << books[i] << (i + 1 < sz(books) ? ' ' : '\n');
+  }
+}
+
+int main(int argc, char* argv[]){
+  map<string, void (*)(params &, fast_writer &)> generators = {
+    {"warmup-pizza", gen_warmup}, {"2014", gen_2014}, {"2015-quali", gen_2015},
+    {"2016-quali", gen_2016}, {"2017-quali", gen_2017}, {"2018-quali", gen_2018},
+    {"2019-quali", gen_2019}, {"2020-practice", gen_2020_practice}, {"2020-quali", gen_2020_quali}
+  };
+  if (argc < 3 || !generators.count(argv[1])){
+    cerr << "Usage: ./gen <problem> <output file> [key=value ...]" << endl << "problems:";
+    trav(g, generators) cerr << ' ' << g.fi;
+    cerr << endl;
+    return 1;
+  }
+  params p;
+  rep(i, 3, argc){
+    string arg = argv[i];
+    size_t eq = arg.find('=');
+    if (eq == string::npos){
+      cerr << "expected key=value, got " << arg << endl;
+      return 1;
+    }
+    p.values[arg.substr(0, eq)] = stod(arg.substr(eq + 1));
+  }
+  rng.seed(p("seed", 1));
+  fast_writer os(argv[2]);
+  if (!os.ok()) return 1;
+  generators[argv[1]](p, os);
+  if (!p.check()) return 1;
+  return os.close() ? 0 : 1;
+}
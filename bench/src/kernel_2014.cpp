@@ -0,0 +1,24 @@
+// 2014 kernel: bfs path search of one car from a random node
+
+#include <random>
+
+#define NO_MAIN
+#include "../../2014/src/main.cpp"
+#include "bench.h"
+
+int main(int argc, char* argv[]){
+  if (argc < 2){
+    cerr << "Usage: ./kernel_2014 <input file> [seconds per kernel]" << endl;
+    return 1;
+  }
+  if (argc > 2) min_seconds = stod(argv[2]);
+  instance I;
+  fast_reader in(argv[1]);
+  I.read(in);
+  mt19937 rng(1);
+  measure("2014 bfs", "path edges", [&](){
+    car c;
+    c.moves = {int(rng() % I.N)};
+    return I.bfs(c).size() - 1;
+  });
+}
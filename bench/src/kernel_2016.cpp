@@ -0,0 +1,30 @@
+// 2016 kernel: greedy choice (and execution) of the next route of a drone.
+// drones are served round robin; once no drone finds a customer anymore the
+// instance is reset to the parsed state
+
+#define NO_MAIN
+#include "../../2016-quali/src/main.cpp"
+#include "bench.h"
+
+int main(int argc, char* argv[]){
+  if (argc < 2){
+    cerr << "Usage: ./kernel_2016 <input file> [seconds per kernel]" << endl;
+    return 1;
+  }
+  if (argc > 2) min_seconds = stod(argv[2]);
+  instance base;
+  fast_reader in(argv[1]);
+  base.read(in);
+  instance I = base;
+  int next = 0, idle = 0;
+  measure("2016 greedy", "customers", [&](){
+    bool served = I.greedy(I.drones[next]);
+    next = (next + 1) % I.D;
+    idle = served ? 0 : idle + 1;
+    if (idle == I.D){
+      I = base;
+      idle = 0;
+    }
+    return I.O;
+  });
+}
@@ -0,0 +1,30 @@
+// 2017 kernel: benefit of putting a random video on a random cache server
+
+#include <random>
+
+#define NO_MAIN
+#include "../../2017-quali/src/main.cpp"
+#include "bench.h"
+
+int main(int argc, char* argv[]){
+  if (argc < 2){
+    cerr << "Usage: ./kernel_2017 <input file> [seconds per kernel]" << endl;
+    return 1;
+  }
+  if (argc > 2) min_seconds = stod(argv[2]);
+  instance I;
+  fast_reader in(argv[1]);
+  I.read(in);
+  mt19937 rng(1);
+  double sink = 0;
+  measure("2017 get_value", "requests", [&](){
+    ll scanned = 0;
+    rep(k, 0, 1024){
+      ll v = rng() % I.V, c = rng() % I.C;
+      sink += I.get_value(v, c);
+      scanned += I.videos[v].requests.size();
+    }
+    return scanned;
+  }, 1024);
+  if (sink < 0) cout << sink << endl;
+}
@@ -0,0 +1,30 @@
+// 2018 kernel: best next ride for a vehicle at a random position and time
+
+#include <random>
+
+#define NO_MAIN
+#include "../../2018-quali/src/main.cpp"
+#include "bench.h"
+
+int main(int argc, char* argv[]){
+  if (argc < 2){
+    cerr << "Usage: ./kernel_2018 <input file> [seconds per kernel]" << endl;
+    return 1;
+  }
+  if (argc > 2) min_seconds = stod(argv[2]);
+  instance I;
+  fast_reader in(argv[1]);
+  I.read(in);
+  mt19937 rng(1);
+  ll found = 0;
+  measure("2018 get_next_ride", "rides", [&](){
+    rep(k, 0, 64){
+      Vehicle v(0);
+      v.position = pt(rng() % I.R, rng() % I.C);
+      v.availability = rng() % I.T;
+      found += I.get_next_ride(&v) != nullptr;
+    }
+    return 64 * I.N;
+  }, 64);
+  if (found < 0) cout << found << endl;
+}
@@ -0,0 +1,47 @@
+// 2019 kernels: transition score of two random slides and the candidate
+// neighbour search over all slides
+
+#define NO_MAIN
+#include "../../2019-quali/src/main.cpp"
+#include "bench.h"
+
+int main(int argc, char* argv[]){
+  if (argc < 2){
+    cerr << "Usage: ./kernel_2019 <input file> [seconds per kernel]" << endl;
+    return 1;
+  }
+  if (argc > 2) min_seconds = stod(argv[2]);
+  instance I;
+  fast_reader in(argv[1]);
+  I.read(in);
+  vector<int> verticals;
+  trav(p, I.photos) {
+    if (!p.horizontal) verticals.pb(p.id);
+    else I.preslideshow.pb({p.id});
+  }
+  I.pair_verticals(verticals);
+  I.build_slide_tags();
+  int n = I.preslideshow.size();
+  if (n == 0){
+    cerr << "instance has no slides" << endl;
+    return 1;
+  }
+  mt19937 rng(1);
+  ll sink = 0;
+  measure("2019 get_score", "tags", [&](){
+    ll tags = 0;
+    rep(k, 0, 4096){
+      int a = rng() % n, b = rng() % n;
+      sink += I.get_score(a, b);
+      tags += I.slide_size(a) + I.slide_size(b);
+    }
+    return tags;
+  }, 4096);
+  measure("2019 get_candidates", "slides", [&](){
+    vector<pair<pair<int,int>,int>> candidates;
+    I.get_candidates(candidates);
+    sink += candidates.size();
+    return n;
+  });
+  if (sink < 0) cout << sink << endl;
+}
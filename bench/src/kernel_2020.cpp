@@ -0,0 +1,31 @@
+// 2020 kernel: the best library to sign up next, i.e. the score of every
+// library on a given day (the first step of the greedy)
+
+#define NO_MAIN
+#include "../../2020-quali/src/main.cpp"
+#include "bench.h"
+
+int main(int argc, char* argv[]){
+  if (argc < 2){
+    cerr << "Usage: ./kernel_2020 <input file> [seconds per kernel]" << endl;
+    return 1;
+  }
+  if (argc > 2) min_seconds = stod(argv[2]);
+  instance I;
+  fast_reader in(argv[1]);
+  I.read(in);
+  int best = -1, day = 0;
+  measure("2020 get_best_library", "libraries", [&](){
+    double best_score = 0;
+    trav(l, libraries){
+      double sc = I.get_library_score(l, day);
+      if (sc > best_score){
+        best_score = sc;
+        best = l.id;
+      }
+    }
+    day = (day + 1) % max(1LL, D);
+    return L;
+  });
+  if (best < -1) cout << best << endl;
+}
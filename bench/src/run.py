@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+Benchmark driver: generates synthetic instances with ./gen, runs every
+solver on them (wall time, peak memory) and then the kernel benchmarks
+(throughput, peak memory). Instances and solver outputs go to ../work/.
+The solvers are built with their own Makefiles, so each <problem>/src/solve
+in the repo gets (re)built by a run. Every solver gets HASHCODE_TIME_LIMIT
+a bit below the timeout, so that runs with long default searches stop on
+their own and write their output instead of being killed.
+Peak memory of small runs is floored by the driver's own size (~12 MB),
+linux carries the resident high-water mark over fork and exec.
+
+Usage: ./run.py [-s small|large] [-t timeout] [-k kernel seconds]
+                [--no-solvers] [--no-kernels] [problem ...]
+"""
+
+import argparse
+import os
+import signal
+import subprocess
+import sys
+import threading
+import time
+
+here = os.path.dirname(os.path.abspath(__file__))
+repo = os.path.normpath(os.path.join(here, "..", ".."))
+work = os.path.normpath(os.path.join(here, "..", "work"))
+
+# generator parameters per size. "data" solvers read ../data/<name>.in relative
+# to their working directory, the others take the input path
+problems = {
+    "warmup-pizza": dict(style="data", kernel=None,
+        small="R=200 C=250 L=4 H=12", large="R=1000 C=1000 L=6 H=14"),
+    "2014": dict(style="data", kernel="kernel_2014",
+        small="N=11348 M=17958 T=3000 C=8", large="N=11348 M=17958 T=54000 C=8"),
+    "2015-quali": dict(style="data", kernel=None,
+        small="R=16 C=100 U=80 P=45 M=625", large="R=64 C=400 U=1000 P=100 M=5000"),
+    "2016-quali": dict(style="path", kernel="kernel_2016",
+        small="P=400 W=10 O=1250 D=30", large="P=2000 W=20 O=10000 D=100"),
+    "2017-quali": dict(style="path", kernel="kernel_2017",
+        small="V=1000 E=100 R=20000 C=50 X=6000", large="V=10000 E=1000 R=200000 C=500 X=50000"),
+    "2018-quali": dict(style="path", kernel="kernel_2018",
+        small="R=200 C=200 F=30 N=1000 B=10 T=5000", large="R=10000 C=10000 F=400 N=10000 B=25 T=50000"),
+    "2019-quali": dict(style="path", kernel="kernel_2019",
+        small="N=4000 tags=500 max_tags=12", large="N=80000 tags=50000 max_tags=20"),
+    "2020-practice": dict(style="path", kernel=None,
+        small="M=5000 N=50 max_pieces=400", large="M=1000000000 N=10000 max_pieces=100000"),
+    "2020-quali": dict(style="path", kernel="kernel_2020",
+        small="B=2000 L=100 D=300 max_books=100", large="B=100000 L=1000 D=1000 max_books=1000"),
+}
+
+
+def run(cmd, cwd, timeout, env=None):
+    # wall time, peak rss in MB and exit status of cmd
+    start = time.time()
+    p = subprocess.Popen(cmd, cwd=cwd, env=env, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    timer = threading.Timer(timeout, p.kill)
+    timer.start()
+    _, status, usage = os.wait4(p.pid, 0)
+    timer.cancel()
+    p.returncode = status
+    return time.time() - start, usage.ru_maxrss / 1024, status
+
+
+def generate(name, size):
+    cfg = problems[name]
+    folder = os.path.join(work, name)
+    if cfg["style"] == "data":
+        os.makedirs(os.path.join(folder, "src"), exist_ok=True)
+        os.makedirs(os.path.join(folder, "out"), exist_ok=True)
+        os.makedirs(os.path.join(folder, "data"), exist_ok=True)
+        path = os.path.join(folder, "data", size + ".in")
+    else:
+        os.makedirs(folder, exist_ok=True)
+        path = os.path.join(folder, size + ".in")
+    subprocess.run(["./gen", name, path] + cfg[size].split(), cwd=here, check=True)
+    return path
+
+
+def bench_solver(name, size, path, timeout):
+    cfg = problems[name]
+    src = os.path.join(repo, name, "src")
+    if subprocess.run(["make"], cwd=src, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL).returncode != 0:
+        print("%-14s %-6s build failed" % (name, size))
+        return
+    if cfg["style"] == "data":
+        cmd, cwd = [os.path.join(src, "solve"), size], os.path.join(work, name, "src")
+    else:
+        cmd, cwd = [os.path.join(src, "solve"), path], os.path.join(work, name)
+    # leave the solver time to write its output before the harness kills it
+    limit = max(timeout - max(2.0, 0.1 * timeout), 0.1 * timeout)
+    env = dict(os.environ, HASHCODE_TIME_LIMIT="%g" % limit)
+    seconds, mb, status = run(cmd, cwd, timeout, env)
+    if os.WIFSIGNALED(status) and os.WTERMSIG(status) == signal.SIGKILL:
+        result = "timeout"
+    elif os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0:
+        result = "ok"
+    else:
+        result = "failed (%d)" % status
+    print("%-14s %-6s %10.2f s %8.1f MB peak  %s" % (name, size, seconds, mb, result))
+    sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("problems", nargs="*", default=list(problems))
+    parser.add_argument("-s", "--size", choices=["small", "large"], default="small")
+    parser.add_argument("-t", "--timeout", type=float, default=120)
+    parser.add_argument("-k", "--kernel-seconds", type=float, default=2)
+    parser.add_argument("--no-solvers", action="store_true")
+    parser.add_argument("--no-kernels", action="store_true")
+    args = parser.parse_args()
+    for name in args.problems:
+        if name not in problems:
+            sys.exit("unknown problem " + name)
+
+    subprocess.run(["make"], cwd=here, check=True)
+    inputs = {name: generate(name, args.size) for name in args.problems}
+    if not args.no_solvers:
+        print("# solvers")
+        for name in args.problems:
+            bench_solver(name, args.size, inputs[name], args.timeout)
+    if not args.no_kernels:
+        print("# kernels")
+        sys.stdout.flush()
+        for name in args.problems:
+            kernel = problems[name]["kernel"]
+            if kernel:
+                subprocess.run(["./" + kernel, inputs[name], str(args.kernel_seconds)], cwd=here)
+
+
+if __name__ == "__main__":
+    main()
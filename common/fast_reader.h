@@ -0,0 +1,267 @@
+/*
+  Input reader shared by all solvers. The input file is memory-mapped and
+  parsed in place by hand-rolled integer, floating point, char and token
+  parsers, which is much faster than going through cin on the large data sets
+  (pipes and other input that cannot be mapped is read into memory instead).
+  Tokens are returned as views into the mapped file (no allocation); they stay
+  valid as long as the reader lives.
+
+  Usage:  fast_reader in(input_file.c_str());
+          in >> N >> M;          // integers, doubles, chars and strings
+          token t = in.next_token();
+
+  Long lists of one record per line can be parsed on all cores with
+  line_chunks, see below.
+*/
+
+#ifndef FAST_READER_H
+#define FAST_READER_H
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct token{
+  // a whitespace free word of the input, pointing into the mapped file
+  const char *data;
+  size_t size;
+
+  std::string str() const { return std::string(data, size); }
+  bool operator==(const token &o) const {
+    return size == o.size && memcmp(data, o.data, size) == 0;
+  }
+};
+
+struct token_hash{
+  size_t operator()(const token &t) const {
+    // fnv-1a
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < t.size; i++) h = (h ^ (unsigned char) t.data[i]) * 1099511628211ULL;
+    return h;
+  }
+};
+
+class fast_reader{
+public:
+  explicit fast_reader(const char *path){
+    int fd = open(path, O_RDONLY);
+    if (fd < 0){ perror(path); exit(1); }
+    struct stat st;
+    if (fstat(fd, &st) < 0){ perror(path); exit(1); }
+    size = 0;
+    if (S_ISREG(st.st_mode) && st.st_size > 0){
+      size = st.st_size;
+#ifdef MAP_POPULATE
+      void *m = mmap(0, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+#else
+      void *m = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+#endif
+      if (m != MAP_FAILED){
+        madvise(m, size, MADV_SEQUENTIAL);
+        mapped = (char *) m;
+        begin = mapped;
+      }
+      else size = 0;
+    }
+    if (!mapped){
+      // pipes, fifos, /proc files or a failed mmap: read until eof into a growing buffer
+      size_t cap = 1 << 16;
+      buffer = (char *) malloc(cap);
+      ssize_t n;
+      while (buffer && (n = ::read(fd, buffer + size, cap - size)) != 0){
+        if (n < 0){
+          if (errno == EINTR) continue;
+          perror(path);
+          exit(1);
+        }
+        size += n;
+        if (size == cap) buffer = (char *) realloc(buffer, cap *= 2);
+      }
+      if (!buffer){ fprintf(stderr, "%s: out of memory\n", path); exit(1); }
+      begin = buffer;
+    }
+    close(fd);
+    cur = begin;
+    end = begin + size;
+  }
+
+  // reader over [b, e) of another reader's input, which has to outlive it
+  fast_reader(const char *b, const char *e){
+    begin = cur = b;
+    end = e;
+  }
+
+  ~fast_reader(){
+    if (mapped) munmap(mapped, size);
+    free(buffer);
+  }
+
+  fast_reader(const fast_reader &) = delete;
+  fast_reader &operator=(const fast_reader &) = delete;
+
+  bool eof(){
+    skip_space();
+    return cur == end;
+  }
+
+  template<class T> T next_int(){
+    skip_space();
+    bool neg = false;
+    if (cur < end && (*cur == '-' || *cur == '+')) neg = *cur++ == '-';
+    typename std::make_unsigned<T>::type x = 0;
+    while (cur < end && (unsigned) (*cur - '0') < 10) x = x * 10 + (*cur++ - '0');
+    return neg ? (T) (0 - x) : (T) x;
+  }
+
+  double next_double(){
+    skip_space();
+    bool neg = false;
+    if (cur < end && (*cur == '-' || *cur == '+')) neg = *cur++ == '-';
+    double x = 0;
+    while (cur < end && (unsigned) (*cur - '0') < 10) x = x * 10 + (*cur++ - '0');
+    if (cur < end && *cur == '.'){
+      cur++;
+      double scale = 1;
+      while (cur < end && (unsigned) (*cur - '0') < 10){
+        x = x * 10 + (*cur++ - '0');
+        scale *= 10;
+      }
+      x /= scale;
+    }
+    if (cur < end && (*cur == 'e' || *cur == 'E')){
+      cur++;
+      int e = next_int<int>();
+      x *= pow10(e);
+    }
+    return neg ? -x : x;
+  }
+
+  char next_char(){
+    skip_space();
+    return cur < end ? *cur++ : 0;
+  }
+
+  token next_token(){
+    skip_space();
+    const char *start = cur;
+    while (cur < end && (unsigned char) *cur > ' ') cur++;
+    return token{start, (size_t) (cur - start)};
+  }
+
+  template<class T>
+  typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value && !std::is_same<T, bool>::value, fast_reader &>::type
+  operator>>(T &x){ x = next_int<T>(); return *this; }
+  fast_reader &operator>>(bool &x){ x = next_int<int>() != 0; return *this; }
+  fast_reader &operator>>(double &x){ x = next_double(); return *this; }
+  fast_reader &operator>>(char &x){ x = next_char(); return *this; }
+  fast_reader &operator>>(token &x){ x = next_token(); return *this; }
+  fast_reader &operator>>(std::string &x){ x = next_token().str(); return *this; }
+
+  // raw access to the remaining input, e.g. to split it between threads
+  const char *position() const { return cur; }
+  const char *limit() const { return end; }
+  void seek(const char *p){ cur = p; }
+
+private:
+  void skip_space(){
+    while (cur < end && (unsigned char) *cur <= ' ') cur++;
+  }
+
+  static double pow10(int e){
+    double r = 1, b = 10;
+    bool neg = e < 0;
+    if (neg) e = -e;
+    while (e){
+      if (e & 1) r *= b;
+      b *= b;
+      e >>= 1;
+    }
+    return neg ? 1 / r : r;
+  }
+
+  char *mapped = 0, *buffer = 0;
+  const char *begin = 0, *cur = 0, *end = 0;
+  size_t size = 0;
+};
+
+class line_chunks{
+  // splits the rest of the input, n records with one record per line, into chunks at line
+  // breaks so that they can be parsed on worker threads. the records of every chunk are
+  // counted first, so each chunk knows the id of its first record and can write straight
+  // into preallocated arrays. if the lines do not match the records (e.g. a record spans
+  // several lines), everything ends up in a single chunk. the reader is left behind the records
+public:
+  line_chunks(fast_reader &in, long long n, size_t min_chunk = 1 << 20){
+    const char *b = in.position(), *e = in.limit();
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t parts = std::min(threads, (size_t) (e - b) / min_chunk + 1);
+    bounds.push_back(b);
+    for (size_t k = 1; k < parts; k++){
+      const char *p = std::max(bounds.back(), b + (e - b) * k / parts);
+      const char *nl = (const char *) memchr(p, '\n', e - p);
+      if (nl == 0) break;
+      if (nl + 1 > bounds.back()) bounds.push_back(nl + 1);
+    }
+    bounds.push_back(e);
+
+    std::vector<long long> count(size(), 0);
+    run([&](int part){ count[part] = count_lines(bounds[part], bounds[part + 1]); });
+    first.assign(size() + 1, 0);
+    for (int part = 0; part < size(); part++) first[part + 1] = first[part] + count[part];
+    if (first.back() != n){
+      bounds = {b, e};
+      first = {0, n};
+    }
+    in.seek(e);
+  }
+
+  int size() const { return bounds.size() - 1; }
+  long long begin_id(int part) const { return first[part]; }
+  long long end_id(int part) const { return first[part + 1]; }
+
+  // calls parse(chunk, part, first id, number of records) for every chunk, each on its own thread
+  template<class F> void parse(F parse){
+    run([&](int part){
+      fast_reader chunk(bounds[part], bounds[part + 1]);
+      parse(chunk, part, first[part], first[part + 1] - first[part]);
+    });
+  }
+
+private:
+  template<class F> void run(F f){
+    if (size() == 1){ f(0); return; }
+    std::vector<std::thread> workers;
+    for (int part = 0; part < size(); part++) workers.emplace_back(f, part);
+    for (auto &w: workers) w.join();
+  }
+
+  static long long count_lines(const char *p, const char *e){
+    // lines with at least one non-space character
+    long long cnt = 0;
+    bool content = false;
+    for (; p < e; p++){
+      if (*p == '\n'){
+        cnt += content;
+        content = false;
+      }
+      else if ((unsigned char) *p > ' ') content = true;
+    }
+    return cnt + content;
+  }
+
+  std::vector<const char *> bounds; // chunk i is [bounds[i], bounds[i + 1])
+  std::vector<long long> first; // id of the first record of each chunk
+};
+
+#endif
@@ -0,0 +1,128 @@
+/*
+  Output writer shared by all solvers. Everything is formatted into one large
+  reusable buffer (integers by a hand-rolled itoa) and handed to the kernel in
+  few big write calls, instead of one flushing cout << ... << endl per line.
+
+  Usage:  fast_writer os(output_file.c_str());
+          os << n << '\n';
+          for (int x: v) os << x << ' ';
+          os.close();            // also done by the destructor
+*/
+
+#ifndef FAST_WRITER_H
+#define FAST_WRITER_H
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+class fast_writer{
+public:
+  explicit fast_writer(const char *path, size_t capacity = 1 << 20) : buf(capacity){
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0){
+      perror(path);
+      failed = true;
+    }
+  }
+
+  ~fast_writer(){
+    close();
+  }
+
+  fast_writer(const fast_writer &) = delete;
+  fast_writer &operator=(const fast_writer &) = delete;
+
+  // false if the file could not be opened or a write failed
+  bool ok() const { return !failed; }
+
+  template<class T>
+  typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value && !std::is_same<T, bool>::value, fast_writer &>::type
+  operator<<(T x){
+    reserve(24);
+    pos = format_int(buf.data() + pos, x) - buf.data();
+    return *this;
+  }
+
+  fast_writer &operator<<(char c){
+    reserve(1);
+    buf[pos++] = c;
+    return *this;
+  }
+
+  fast_writer &operator<<(const char *s){
+    append(s, strlen(s));
+    return *this;
+  }
+
+  fast_writer &operator<<(const std::string &s){
+    append(s.data(), s.size());
+    return *this;
+  }
+
+  void append(const char *s, size_t n){
+    if (n > buf.size()){
+      flush();
+      write_all(s, n);
+      return;
+    }
+    reserve(n);
+    memcpy(buf.data() + pos, s, n);
+    pos += n;
+  }
+
+  void flush(){
+    write_all(buf.data(), pos);
+    pos = 0;
+  }
+
+  // flushes and closes the file, returns ok()
+  bool close(){
+    if (fd >= 0){
+      flush();
+      if (::close(fd) != 0) failed = true;
+      fd = -1;
+    }
+    return !failed;
+  }
+
+  // writes x in decimal to p and returns the end of the digits
+  template<class T> static char *format_int(char *p, T x){
+    typename std::make_unsigned<T>::type u = x;
+    if (x < 0){
+      *p++ = '-';
+      u = 0 - u;
+    }
+    char tmp[24];
+    int n = 0;
+    do { tmp[n++] = char('0' + u % 10); u /= 10; } while (u > 0);
+    while (n > 0) *p++ = tmp[--n];
+    return p;
+  }
+
+private:
+  void reserve(size_t n){
+    if (pos + n > buf.size()) flush();
+  }
+
+  void write_all(const char *p, size_t n){
+    if (fd < 0) return;
+    while (n > 0){
+      ssize_t w = ::write(fd, p, n);
+      if (w <= 0){ failed = true; return; }
+      p += w;
+      n -= w;
+    }
+  }
+
+  std::vector<char> buf;
+  size_t pos = 0;
+  int fd = -1;
+  bool failed = false;
+};
+
+#endif
@@ -0,0 +1,203 @@
+/*
+  Binary snapshot of a parsed instance, stored next to the input as
+  <input>.cache. Set HASHCODE_CACHE=1 to use it: the first run parses the text
+  input as usual and writes the snapshot, later runs map the snapshot instead
+  of parsing. Arrays can be used in place (zero-copy views into the mapping,
+  private copy-on-write pages) or copied into vectors.
+
+  A snapshot is only used if its format version, solver name and layout
+  version match and the input file still has the size and modification time
+  it was built from; otherwise it is rebuilt.
+
+  Usage:  read_instance(I, input_file, "2018-quali", 1);
+  with    void read(fast_reader &in);    // parse the text input
+          void save(cache_writer &snapshot);  // put() everything read() produced
+          void load(cache_reader &snapshot);  // get() it back in the same order
+*/
+
+#ifndef INSTANCE_CACHE_H
+#define INSTANCE_CACHE_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "fast_reader.h"
+
+struct cache_header{
+  char magic[8]; // "HCCACHE\0"
+  uint32_t format; // cache_header layout
+  uint32_t version; // layout of the solver's data
+  char solver[32];
+  uint64_t input_size;
+  int64_t input_mtime_sec, input_mtime_nsec;
+  uint64_t bytes; // payload after the header
+};
+
+const uint32_t cache_format = 1;
+const size_t cache_align = 64; // every array starts on a cache line
+
+inline cache_header make_cache_header(const char *solver, uint32_t version, const struct stat &input){
+  cache_header h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, "HCCACHE", 8);
+  h.format = cache_format;
+  h.version = version;
+  strncpy(h.solver, solver, sizeof(h.solver) - 1);
+  h.input_size = input.st_size;
+  h.input_mtime_sec = input.st_mtim.tv_sec;
+  h.input_mtime_nsec = input.st_mtim.tv_nsec;
+  return h;
+}
+
+// std::pair is not trivially copyable (its assignment is user-provided) but is safe to memcpy
+template<class T> struct is_plain : std::integral_constant<bool,
+  std::is_trivially_copy_constructible<T>::value && std::is_trivially_destructible<T>::value>{};
+
+class cache_writer{
+public:
+  template<class T> void put(const T &x){
+    static_assert(is_plain<T>::value, "only plain data can be cached");
+    append(&x, sizeof(T), alignof(T));
+  }
+
+  template<class T> void put(const T *p, size_t n){
+    static_assert(is_plain<T>::value, "only plain data can be cached");
+    put<uint64_t>(n);
+    append(p, n * sizeof(T), cache_align);
+  }
+
+  template<class T> void put(const std::vector<T> &v){ put(v.data(), v.size()); }
+
+  // writes header and payload to a temporary file that is renamed to path
+  bool save(const std::string &path, const char *solver, uint32_t version, const struct stat &input){
+    cache_header h = make_cache_header(solver, version, input);
+    h.bytes = data.size();
+    std::string tmp = path + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    if (f == 0) return false;
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    if (ok && !data.empty()) ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    ok = (fclose(f) == 0) && ok;
+    if (ok) ok = rename(tmp.c_str(), path.c_str()) == 0;
+    if (!ok) remove(tmp.c_str());
+    return ok;
+  }
+
+private:
+  void append(const void *p, size_t n, size_t align){
+    // payload offsets are aligned; the header size is a multiple of 8 and the mapping page aligned
+    size_t at = (data.size() + sizeof(cache_header) + align - 1) / align * align - sizeof(cache_header);
+    data.resize(at + n);
+    if (n) memcpy(data.data() + at, p, n);
+  }
+
+  std::vector<char> data;
+};
+
+class cache_reader{
+public:
+  cache_reader(){}
+  ~cache_reader(){ close(); }
+  cache_reader(const cache_reader &) = delete;
+  cache_reader &operator=(const cache_reader &) = delete;
+
+  // maps path if it is a valid snapshot of the given input
+  bool open(const std::string &path, const char *solver, uint32_t version, const struct stat &input){
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && (size_t) st.st_size >= sizeof(cache_header);
+    if (ok){
+      void *m = mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (m != MAP_FAILED){
+        base = (char *) m;
+        size = st.st_size;
+      }
+    }
+    ::close(fd);
+    if (base == 0) return false;
+    cache_header want = make_cache_header(solver, version, input), &have = *(cache_header *) base;
+    want.bytes = size - sizeof(cache_header);
+    if (memcmp(&want, &have, sizeof(cache_header)) != 0){
+      close();
+      return false;
+    }
+    cur = sizeof(cache_header);
+    return true;
+  }
+
+  template<class T> T get(){
+    T x;
+    memcpy(&x, take(sizeof(T), alignof(T)), sizeof(T));
+    return x;
+  }
+
+  // zero-copy view of the next array, valid as long as the reader is open
+  template<class T> T *view(size_t &n){
+    n = get<uint64_t>();
+    return (T *) take(n * sizeof(T), cache_align);
+  }
+
+  template<class T> void get(std::vector<T> &v){
+    size_t n;
+    T *p = view<T>(n);
+    v.assign(p, p + n);
+  }
+
+  void close(){
+    if (base) munmap(base, size);
+    base = 0;
+    size = cur = 0;
+  }
+
+private:
+  char *take(size_t n, size_t align){
+    cur = (cur + align - 1) / align * align;
+    if (cur + n > size){
+      fprintf(stderr, "instance cache is truncated\n");
+      exit(1);
+    }
+    char *p = base + cur;
+    cur += n;
+    return p;
+  }
+
+  char *base = 0;
+  size_t size = 0, cur = 0;
+};
+
+// reads the instance from its snapshot if HASHCODE_CACHE is set and the snapshot is
+// valid, otherwise parses the text input and, if enabled, writes the snapshot.
+// the snapshot stays mapped until the program ends so loaded views remain valid
+template<class I> void read_instance(I &inst, const std::string &input_file, const char *solver, uint32_t version){
+  static cache_reader cache;
+  const char *env = getenv("HASHCODE_CACHE");
+  bool enabled = env && *env && strcmp(env, "0") != 0;
+  struct stat st;
+  std::string cache_file = input_file + ".cache";
+  if (enabled && stat(input_file.c_str(), &st) == 0 && cache.open(cache_file, solver, version, st)){
+    inst.load(cache);
+    return;
+  }
+  {
+    fast_reader in(input_file.c_str());
+    inst.read(in);
+  }
+  if (enabled && stat(input_file.c_str(), &st) == 0){
+    cache_writer out;
+    inst.save(out);
+    if (!out.save(cache_file, solver, version, st)) perror(cache_file.c_str());
+  }
+}
+
+#endif
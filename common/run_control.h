@@ -0,0 +1,118 @@
+/*
+  Run controller shared by the solvers: a wall-clock budget and SIGINT /
+  SIGTERM handling, so that a run that is out of time or gets preempted
+  stops searching and still writes the best solution it has.
+
+  Usage:  run_control::start(time_limit);   // first thing in main, seconds, 0 = no limit
+          while (... && !run_control::stopped())   // a relaxed atomic load
+          run_control::remaining()          // seconds left, e.g. for solver time limits
+          run_control::budget(seconds)      // min(seconds, remaining())
+
+  HASHCODE_TIME_LIMIT (seconds) overrides the solver's budget. start() blocks
+  both signals in the calling thread, and all threads created later inherit
+  that, so it has to run before any other thread is started. A watcher thread
+  then waits for a signal or the deadline and sets the stop flag; a second
+  signal ends the process at once.
+*/
+
+#ifndef RUN_CONTROL_H
+#define RUN_CONTROL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+namespace run_control{
+
+typedef std::chrono::steady_clock clock;
+
+struct state{
+  std::atomic<bool> stop{false};
+  clock::time_point begin = clock::now();
+  double limit = 0; // seconds, 0 = none
+};
+
+inline state &get(){
+  static state s;
+  return s;
+}
+
+// true once the budget is used up or a signal arrived
+inline bool stopped(){
+  return get().stop.load(std::memory_order_relaxed);
+}
+
+inline double elapsed(){
+  return std::chrono::duration<double>(clock::now() - get().begin).count();
+}
+
+// seconds until the deadline, infinity without a budget, 0 once stopped
+inline double remaining(){
+  if (stopped()) return 0;
+  if (get().limit <= 0) return std::numeric_limits<double>::infinity();
+  return std::max(0.0, get().limit - elapsed());
+}
+
+// min(seconds, remaining()), for searches that have their own time budget
+inline double budget(double seconds){
+  return std::min(seconds, remaining());
+}
+
+inline void request_stop(){
+  get().stop.store(true);
+}
+
+inline void start(double seconds){
+  state &s = get();
+  const char *env = getenv("HASHCODE_TIME_LIMIT");
+  if (env && *env) seconds = atof(env);
+  s.limit = seconds;
+  sigset_t set;
+  sigemptyset(&set);
+  sigaddset(&set, SIGINT);
+  sigaddset(&set, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &set, 0);
+  std::thread([set]{
+    bool timed = get().limit > 0;
+    int signals = 0;
+    while (true){
+      int sig;
+      if (timed){
+        double left = std::max(0.0, get().limit - elapsed());
+        timespec ts;
+        ts.tv_sec = (time_t) left;
+        ts.tv_nsec = (long) ((left - floor(left)) * 1e9);
+        sig = sigtimedwait(&set, 0, &ts);
+        if (sig < 0){
+          if (errno == EAGAIN){
+            timed = false;
+            request_stop();
+          }
+          continue;
+        }
+      }
+      else if (sigwait(&set, &sig) != 0) continue;
+      if (++signals > 1){
+        fprintf(stderr, "caught signal %d again, exiting\n", sig);
+        _exit(128 + sig);
+      }
+      fprintf(stderr, "caught signal %d, stopping after writing the best solution\n", sig);
+      timed = false;
+      request_stop();
+    }
+  }).detach();
+}
+
+}
+
+#endif
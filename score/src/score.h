@@ -0,0 +1,97 @@
+/*
+  Shared parts of the scorers. The input is trusted and read with a plain
+  fast_reader; the solution file is read through checked_reader, which
+  checks every number and stops with the file and line of the first
+  violation.
+
+  Every scorer is called as  ./score_<problem> <input file> <output file>
+  and prints the official score, or an error on stderr with exit code 1.
+*/
+
+#ifndef SCORE_H
+#define SCORE_H
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "../../common/fast_reader.h"
+
+typedef long long ll;
+
+class checked_reader{
+public:
+  explicit checked_reader(const char *path) : in(path), path(path), start(in.position()){}
+
+  __attribute__((format(printf, 2, 3), noreturn))
+  void fail(const char *fmt, ...){
+    const char *p = in.position();
+    fprintf(stderr, "%s:%lld: ", path, 1 + (ll) std::count(start, p, '\n'));
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+    exit(1);
+  }
+
+  // for violations found after parsing, without a line number
+  __attribute__((format(printf, 2, 3), noreturn))
+  void reject(const char *fmt, ...){
+    fprintf(stderr, "%s: ", path);
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+    exit(1);
+  }
+
+  // next token as an integer in [lo, hi]
+  ll integer(const char *what, ll lo, ll hi){
+    return integer(word(what), what, lo, hi);
+  }
+
+  ll integer(token t, const char *what, ll lo, ll hi){
+    size_t i = t.size && (t.data[0] == '-' || t.data[0] == '+');
+    bool ok = i < t.size && t.size - i <= 18;
+    ll x = 0;
+    for (; ok && i < t.size; i++){
+      ok = (unsigned) (t.data[i] - '0') < 10;
+      x = x * 10 + (t.data[i] - '0');
+    }
+    if (!ok) fail("expected %s, got '%.*s'", what, (int) std::min<size_t>(t.size, 40), t.data);
+    if (t.data[0] == '-') x = -x;
+    if (x < lo || x > hi) fail("%s %lld is not in [%lld, %lld]", what, x, lo, hi);
+    return x;
+  }
+
+  token word(const char *what){
+    token t = in.next_token();
+    if (t.size == 0) fail("expected %s, got end of file", what);
+    return t;
+  }
+
+  // true if only blanks are left on the current line
+  bool at_line_end(){
+    const char *p = in.position(), *e = in.limit();
+    while (p < e && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    return p == e || *p == '\n';
+  }
+
+  void expect_end(){
+    if (!in.eof()) fail("unexpected content after the solution");
+  }
+
+private:
+  fast_reader in;
+  const char *path, *start;
+};
+
+inline void usage(const char *name){
+  fprintf(stderr, "Usage: %s <input file> <output file>\n", name);
+  exit(2);
+}
+
+#endif
@@ -0,0 +1,71 @@
+// scorer for 2014 street view routing: every itinerary starts at junction S,
+// follows streets in an allowed direction and takes at most T seconds.
+// score = total length of the distinct streets visited
+
+#include <iostream>
+#include <vector>
+
+#include "score.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]){
+  if (argc < 3) usage(argv[0]);
+  fast_reader in(argv[1]);
+  ll N, M, T, C, S;
+  in >> N >> M >> T >> C >> S;
+  for (ll i = 0; i < N; i++){
+    in.next_double();
+    in.next_double();
+  }
+  // streets leaving every junction, adjacency in compressed form:
+  // junction a has the streets street[begin[a], begin[a+1])
+  vector<int> from(M), to(M), dir(M), cost(M), length(M);
+  vector<int> begin(N + 1, 0);
+  for (ll i = 0; i < M; i++){
+    in >> from[i] >> to[i] >> dir[i] >> cost[i] >> length[i];
+    begin[from[i] + 1]++;
+    if (dir[i] == 2) begin[to[i] + 1]++;
+  }
+  for (ll a = 0; a < N; a++) begin[a + 1] += begin[a];
+  vector<int> next(begin[N]), street(begin[N]);
+  {
+    vector<int> pos(begin.begin(), begin.end() - 1);
+    for (ll i = 0; i < M; i++){
+      next[pos[from[i]]] = to[i];
+      street[pos[from[i]]++] = i;
+      if (dir[i] == 2){
+        next[pos[to[i]]] = from[i];
+        street[pos[to[i]]++] = i;
+      }
+    }
+  }
+
+  checked_reader out(argv[2]);
+  ll cars = out.integer("number of itineraries", 0, C);
+  vector<char> visited(M, 0);
+  ll score = 0;
+  for (ll c = 0; c < cars; c++){
+    ll n = out.integer("number of junctions", 1, 1LL << 40);
+    ll cur = out.integer("junction", 0, N - 1), time = 0;
+    if (cur != S) out.fail("itinerary %lld starts at %lld instead of %lld", c, cur, S);
+    for (ll k = 1; k < n; k++){
+      ll v = out.integer("junction", 0, N - 1);
+      int s = -1;
+      for (int j = begin[cur]; j < begin[cur + 1]; j++) if (next[j] == v){
+        s = street[j];
+        break;
+      }
+      if (s == -1) out.fail("itinerary %lld: no street from %lld to %lld", c, cur, v);
+      time += cost[s];
+      if (time > T) out.fail("itinerary %lld takes longer than %lld seconds", c, T);
+      if (!visited[s]){
+        visited[s] = 1;
+        score += length[s];
+      }
+      cur = v;
+    }
+  }
+  out.expect_end();
+  cout << score << endl;
+}
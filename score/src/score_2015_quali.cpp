@@ -0,0 +1,52 @@
+// scorer for 2015 data center: one line per server, either x or row, first
+// slot and pool. servers lie inside a row, on available slots and do not
+// overlap. score = min over pools of the capacity left when the pool's
+// strongest row fails
+
+#include <iostream>
+#include <vector>
+
+#include "score.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]){
+  if (argc < 3) usage(argv[0]);
+  fast_reader in(argv[1]);
+  ll R, S, U, P, M;
+  in >> R >> S >> U >> P >> M;
+  vector<char> taken(R * S, 0); // unavailable or occupied slots
+  for (ll i = 0; i < U; i++){
+    ll r, s;
+    in >> r >> s;
+    taken[r * S + s] = 1;
+  }
+  vector<ll> size(M), cap(M);
+  for (ll i = 0; i < M; i++) in >> size[i] >> cap[i];
+
+  checked_reader out(argv[2]);
+  vector<ll> row_cap(P * R, 0), pool_cap(P, 0);
+  for (ll i = 0; i < M; i++){
+    token t = out.word("server position or x");
+    if (t.size == 1 && t.data[0] == 'x') continue;
+    ll r = out.integer(t, "row", 0, R - 1);
+    ll s = out.integer("slot", 0, S - 1);
+    ll p = out.integer("pool", 0, P - 1);
+    if (s + size[i] > S) out.fail("server %lld does not fit into row %lld", i, r);
+    for (ll k = s; k < s + size[i]; k++){
+      if (taken[r * S + k]) out.fail("server %lld uses unavailable or occupied slot (%lld, %lld)", i, r, k);
+      taken[r * S + k] = 1;
+    }
+    row_cap[p * R + r] += cap[i];
+    pool_cap[p] += cap[i];
+  }
+  out.expect_end();
+  ll score = -1;
+  for (ll p = 0; p < P; p++){
+    ll worst = 0;
+    for (ll r = 0; r < R; r++) worst = max(worst, row_cap[p * R + r]);
+    ll guaranteed = pool_cap[p] - worst;
+    if (score == -1 || guaranteed < score) score = guaranteed;
+  }
+  cout << max(score, 0LL) << endl;
+}
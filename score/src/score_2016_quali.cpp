@@ -0,0 +1,141 @@
+// scorer for 2016 drone delivery. each drone runs its commands in the order
+// they appear: load and unload at a warehouse or deliver to an order take the
+// flight distance plus one turn, wait takes the given turns. the payload of a
+// drone never exceeds the maximum, drones only unload and deliver what they
+// carry, warehouses only hand out what they have in stock and orders only
+// receive what they need; everything completes within the T turns.
+// score = sum over completed orders of ceil((T - t) / T * 100), t being the
+// turn of the last delivery to that order
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "score.h"
+
+using namespace std;
+
+struct command{
+  char type; // L, U, D or W
+  ll target, product, count; // warehouse or order; turns for W
+  ll id; // position in the solution
+};
+
+struct event{
+  ll turn;
+  int type; // 0 = load, 1 = unload
+  ll warehouse, product, count, id;
+  bool operator<(const event &o) const {
+    return turn != o.turn ? turn < o.turn : type < o.type;
+  }
+};
+
+ll dis(ll r1, ll c1, ll r2, ll c2){
+  return (ll) ceil(sqrt(double((r1 - r2) * (r1 - r2) + (c1 - c2) * (c1 - c2))));
+}
+
+int main(int argc, char* argv[]){
+  if (argc < 3) usage(argv[0]);
+  fast_reader in(argv[1]);
+  ll R, C, D, T, M, P, W, O;
+  in >> R >> C >> D >> T >> M >> P;
+  vector<ll> weight(P);
+  for (ll i = 0; i < P; i++) in >> weight[i];
+  in >> W;
+  vector<ll> wr(W), wc(W), stock(W * P);
+  for (ll w = 0; w < W; w++){
+    in >> wr[w] >> wc[w];
+    for (ll i = 0; i < P; i++) in >> stock[w * P + i];
+  }
+  // items still needed by each order as sorted (product, count) runs:
+  // order o owns [order_begin[o], order_begin[o+1]) of need
+  in >> O;
+  vector<ll> orow(O), ocol(O), order_begin(O + 1, 0), items_left(O);
+  vector<pair<ll, ll> > need;
+  for (ll o = 0; o < O; o++){
+    ll n;
+    in >> orow[o] >> ocol[o] >> n;
+    vector<ll> items(n);
+    for (ll &x: items) in >> x;
+    sort(items.begin(), items.end());
+    for (ll i = 0; i < n; i++){
+      if (i == 0 || items[i] != items[i - 1]) need.push_back({items[i], 0});
+      need.back().second++;
+    }
+    order_begin[o + 1] = need.size();
+    items_left[o] = n;
+  }
+
+  checked_reader out(argv[2]);
+  ll Q = out.integer("number of commands", 0, 1LL << 40);
+  vector<vector<command> > commands(D);
+  for (ll q = 0; q < Q; q++){
+    ll d = out.integer("drone", 0, D - 1);
+    token t = out.word("command");
+    if (t.size != 1 || (t.data[0] != 'L' && t.data[0] != 'U' && t.data[0] != 'D' && t.data[0] != 'W'))
+      out.fail("unknown command '%.*s'", (int) min<size_t>(t.size, 20), t.data);
+    command c = {t.data[0], 0, 0, 0, q};
+    if (c.type == 'W') c.count = out.integer("number of turns", 0, T);
+    else {
+      c.target = c.type == 'D' ? out.integer("order", 0, O - 1) : out.integer("warehouse", 0, W - 1);
+      c.product = out.integer("product", 0, P - 1);
+      c.count = out.integer("number of items", 1, 1LL << 40);
+    }
+    commands[d].push_back(c);
+  }
+  out.expect_end();
+
+  // drones are independent apart from the warehouse stock, which is checked
+  // afterwards in turn order. an unload is only available to loads that
+  // complete in a later turn
+  vector<event> events;
+  vector<ll> carried(P, 0), done_at(O, -1);
+  ll score = 0;
+  for (ll d = 0; d < D; d++){
+    ll r = wr[0], c = wc[0], turn = 0, load = 0;
+    fill(carried.begin(), carried.end(), 0);
+    for (command &x: commands[d]){
+      if (x.type == 'W'){
+        turn += x.count;
+        if (turn > T) out.reject("command %lld (drone %lld) ends after turn %lld", x.id, d, T);
+        continue;
+      }
+      ll tr = x.type == 'D' ? orow[x.target] : wr[x.target], tc = x.type == 'D' ? ocol[x.target] : wc[x.target];
+      turn += dis(r, c, tr, tc) + 1;
+      r = tr;
+      c = tc;
+      if (turn > T) out.reject("command %lld (drone %lld) ends after turn %lld", x.id, d, T);
+      if (x.type == 'L'){
+        load += x.count * weight[x.product];
+        if (load > M) out.reject("command %lld (drone %lld) exceeds the maximum payload", x.id, d);
+        carried[x.product] += x.count;
+        events.push_back({turn - 1, 0, x.target, x.product, x.count, x.id});
+        continue;
+      }
+      if (carried[x.product] < x.count) out.reject("command %lld (drone %lld) hands over items it does not carry", x.id, d);
+      carried[x.product] -= x.count;
+      load -= x.count * weight[x.product];
+      if (x.type == 'U'){
+        events.push_back({turn - 1, 1, x.target, x.product, x.count, x.id});
+        continue;
+      }
+      auto first = need.begin() + order_begin[x.target], last = need.begin() + order_begin[x.target + 1];
+      auto it = lower_bound(first, last, make_pair(x.product, 0LL));
+      if (it == last || it->first != x.product || it->second < x.count)
+        out.reject("command %lld (drone %lld) delivers more than order %lld needs", x.id, d, x.target);
+      it->second -= x.count;
+      items_left[x.target] -= x.count;
+      done_at[x.target] = max(done_at[x.target], turn - 1);
+    }
+  }
+  sort(events.begin(), events.end());
+  for (event &e: events){
+    ll &s = stock[e.warehouse * P + e.product];
+    if (e.type == 1) s += e.count;
+    else if ((s -= e.count) < 0)
+      out.reject("command %lld loads product %lld at warehouse %lld in turn %lld, which is out of stock", e.id, e.product, e.warehouse, e.turn);
+  }
+  for (ll o = 0; o < O; o++) if (items_left[o] == 0 && done_at[o] >= 0) score += (100 * (T - done_at[o]) + T - 1) / T;
+  cout << score << endl;
+}
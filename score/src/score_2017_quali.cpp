@@ -0,0 +1,67 @@
+// scorer for 2017 streaming videos: one line per used cache server with its
+// videos, at most X megabytes per server. score = saved latency of all
+// requests times 1000 divided by the number of requests, rounded down
+
+#include <iostream>
+#include <vector>
+
+#include "score.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]){
+  if (argc < 3) usage(argv[0]);
+  fast_reader in(argv[1]);
+  ll V, E, R, C, X;
+  in >> V >> E >> R >> C >> X;
+  vector<ll> size(V);
+  for (ll i = 0; i < V; i++) in >> size[i];
+  // connected servers of endpoint e: cache[begin[e], begin[e+1]) with latency
+  vector<ll> data_center(E), begin(E + 1, 0), cache, latency;
+  for (ll e = 0; e < E; e++){
+    ll k;
+    in >> data_center[e] >> k;
+    for (ll j = 0; j < k; j++){
+      ll c, l;
+      in >> c >> l;
+      cache.push_back(c);
+      latency.push_back(l);
+    }
+    begin[e + 1] = cache.size();
+  }
+
+  // videos on each server, one bit per (server, video)
+  checked_reader out(argv[2]);
+  ll words = V / 64 + 1;
+  vector<uint64_t> stored(C * words, 0);
+  vector<char> listed(C, 0);
+  ll N = out.integer("number of cache servers", 0, C);
+  for (ll i = 0; i < N; i++){
+    ll c = out.integer("cache server", 0, C - 1);
+    if (listed[c]) out.fail("cache server %lld is listed twice", c);
+    listed[c] = 1;
+    ll used = 0;
+    while (!out.at_line_end()){
+      ll v = out.integer("video", 0, V - 1);
+      uint64_t &w = stored[c * words + v / 64], bit = uint64_t(1) << (v % 64);
+      if (w & bit) out.fail("video %lld is listed twice on cache server %lld", v, c);
+      w |= bit;
+      used += size[v];
+    }
+    if (used > X) out.fail("cache server %lld holds %lld megabytes, the capacity is %lld", c, used, X);
+  }
+  out.expect_end();
+
+  ll saved = 0, requests = 0;
+  for (ll r = 0; r < R; r++){
+    ll v, e, n;
+    in >> v >> e >> n;
+    ll best = data_center[e];
+    for (ll j = begin[e]; j < begin[e + 1]; j++){
+      if ((stored[cache[j] * words + v / 64] >> (v % 64)) & 1) best = min(best, latency[j]);
+    }
+    saved += n * (data_center[e] - best);
+    requests += n;
+  }
+  cout << (requests ? saved * 1000 / requests : 0) << endl;
+}
@@ -0,0 +1,44 @@
+// scorer for 2018 self-driving rides: one line per vehicle with its rides in
+// order, every ride assigned at most once. a vehicle starts at (0, 0) at step
+// 0 and waits at the start of a ride until its earliest start. a ride earns
+// its distance if it finishes by its latest finish (and by T), plus the bonus
+// B if it started at its earliest start; late rides earn nothing
+
+#include <iostream>
+#include <vector>
+
+#include "score.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]){
+  if (argc < 3) usage(argv[0]);
+  fast_reader in(argv[1]);
+  ll R, C, F, N, B, T;
+  in >> R >> C >> F >> N >> B >> T;
+  vector<ll> a(N), b(N), x(N), y(N), s(N), f(N);
+  for (ll i = 0; i < N; i++) in >> a[i] >> b[i] >> x[i] >> y[i] >> s[i] >> f[i];
+
+  checked_reader out(argv[2]);
+  vector<char> assigned(N, 0);
+  ll score = 0;
+  for (ll v = 0; v < F; v++){
+    ll m = out.integer("number of rides", 0, N);
+    ll r = 0, c = 0, step = 0;
+    for (ll k = 0; k < m; k++){
+      ll i = out.integer("ride", 0, N - 1);
+      if (assigned[i]) out.fail("ride %lld is assigned twice", i);
+      assigned[i] = 1;
+      step += llabs(r - a[i]) + llabs(c - b[i]);
+      bool bonus = step <= s[i];
+      step = max(step, s[i]);
+      ll d = llabs(a[i] - x[i]) + llabs(b[i] - y[i]);
+      step += d;
+      r = x[i];
+      c = y[i];
+      if (step <= min(f[i], T)) score += d + (bonus ? B : 0);
+    }
+  }
+  out.expect_end();
+  cout << score << endl;
+}
@@ -0,0 +1,70 @@
+// scorer for 2019 photo slideshow: one slide per line, a horizontal photo or
+// two different vertical photos, every photo used at most once.
+// score = sum over neighbouring slides of min(common tags, tags only in the
+// first, tags only in the second)
+
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#include "score.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]){
+  if (argc < 3) usage(argv[0]);
+  fast_reader in(argv[1]);
+  ll N;
+  in >> N;
+  // interned, sorted tags of photo i: tags[begin[i], begin[i+1])
+  vector<char> horizontal(N);
+  vector<ll> begin(N + 1, 0);
+  vector<uint32_t> tags;
+  unordered_map<token, uint32_t, token_hash> ids;
+  for (ll i = 0; i < N; i++){
+    char o;
+    ll k;
+    in >> o >> k;
+    horizontal[i] = o == 'H';
+    for (ll j = 0; j < k; j++) tags.push_back(ids.emplace(in.next_token(), (uint32_t) ids.size()).first->second);
+    sort(tags.begin() + begin[i], tags.end());
+    tags.erase(unique(tags.begin() + begin[i], tags.end()), tags.end());
+    begin[i + 1] = tags.size();
+  }
+
+  checked_reader out(argv[2]);
+  ll S = out.integer("number of slides", 0, N);
+  vector<char> used(N, 0);
+  vector<uint32_t> prev, cur;
+  ll score = 0;
+  for (ll s = 0; s < S; s++){
+    ll a = out.integer("photo", 0, N - 1), b = -1;
+    if (!out.at_line_end()) b = out.integer("photo", 0, N - 1);
+    if (!out.at_line_end()) out.fail("slide %lld has more than two photos", s);
+    if (b == -1 && !horizontal[a]) out.fail("slide %lld holds a single vertical photo", s);
+    if (b != -1 && (horizontal[a] || horizontal[b] || a == b)) out.fail("slide %lld needs two different vertical photos", s);
+    if (used[a] || (b != -1 && used[b])) out.fail("slide %lld uses a photo twice", s);
+    used[a] = 1;
+    cur.assign(tags.begin() + begin[a], tags.begin() + begin[a + 1]);
+    if (b != -1){
+      used[b] = 1;
+      size_t n = cur.size();
+      cur.insert(cur.end(), tags.begin() + begin[b], tags.begin() + begin[b + 1]);
+      inplace_merge(cur.begin(), cur.begin() + n, cur.end());
+      cur.erase(unique(cur.begin(), cur.end()), cur.end());
+    }
+    if (s > 0){
+      ll common = 0;
+      for (size_t i = 0, j = 0; i < prev.size() && j < cur.size();){
+        if (prev[i] == cur[j]){ common++; i++; j++; }
+        else if (prev[i] < cur[j]) i++;
+        else j++;
+      }
+      score += min(common, min((ll) prev.size() - common, (ll) cur.size() - common));
+    }
+    swap(prev, cur);
+  }
+  out.expect_end();
+  cout << score << endl;
+}
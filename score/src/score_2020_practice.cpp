@@ -0,0 +1,32 @@
+// scorer for the 2020 practice round: distinct pizza types with at most M
+// slices in total. score = number of slices
+
+#include <iostream>
+#include <vector>
+
+#include "score.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]){
+  if (argc < 3) usage(argv[0]);
+  fast_reader in(argv[1]);
+  ll M, N;
+  in >> M >> N;
+  vector<ll> pieces(N);
+  for (ll i = 0; i < N; i++) in >> pieces[i];
+
+  checked_reader out(argv[2]);
+  ll K = out.integer("number of pizza types", 0, N);
+  vector<char> ordered(N, 0);
+  ll score = 0;
+  for (ll k = 0; k < K; k++){
+    ll i = out.integer("pizza type", 0, N - 1);
+    if (ordered[i]) out.fail("pizza type %lld is ordered twice", i);
+    ordered[i] = 1;
+    score += pieces[i];
+  }
+  out.expect_end();
+  if (score > M) out.reject("%lld slices ordered, at most %lld are allowed", score, M);
+  cout << score << endl;
+}
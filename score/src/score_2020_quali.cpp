@@ -0,0 +1,58 @@
+// scorer for 2020 book scanning: libraries sign up one after another in the
+// listed order, each at most once and only with its own books. after signing
+// up a library scans its listed books in order, at its daily rate, until day
+// D. score = sum of scores of the distinct books scanned
+
+#include <iostream>
+#include <vector>
+
+#include "score.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]){
+  if (argc < 3) usage(argv[0]);
+  fast_reader in(argv[1]);
+  ll B, L, D;
+  in >> B >> L >> D;
+  vector<ll> score_of(B);
+  for (ll i = 0; i < B; i++) in >> score_of[i];
+  // books of library l: books[begin[l], begin[l+1])
+  vector<ll> signup(L), rate(L), begin(L + 1, 0);
+  vector<int> books;
+  for (ll l = 0; l < L; l++){
+    ll n;
+    in >> n >> signup[l] >> rate[l];
+    for (ll j = 0; j < n; j++) books.push_back(in.next_int<int>());
+    begin[l + 1] = books.size();
+  }
+
+  checked_reader out(argv[2]);
+  ll A = out.integer("number of libraries", 0, L);
+  vector<char> signed_up(L, 0), scanned(B, 0);
+  // while library l is checked, mark[b] is 2 * l + 1 if b is one of its
+  // books and 2 * l + 2 once b was listed
+  vector<ll> mark(B, 0);
+  ll day = 0, score = 0;
+  for (ll a = 0; a < A; a++){
+    ll l = out.integer("library", 0, L - 1);
+    ll K = out.integer("number of books", 1, B);
+    if (signed_up[l]) out.fail("library %lld signs up twice", l);
+    signed_up[l] = 1;
+    for (ll j = begin[l]; j < begin[l + 1]; j++) mark[books[j]] = 2 * l + 1;
+    day += signup[l];
+    ll capacity = day < D ? (D - day) * rate[l] : 0;
+    for (ll k = 0; k < K; k++){
+      ll b = out.integer("book", 0, B - 1);
+      if (mark[b] == 2 * l + 2) out.fail("book %lld is listed twice for library %lld", b, l);
+      if (mark[b] != 2 * l + 1) out.fail("library %lld does not have book %lld", l, b);
+      mark[b] = 2 * l + 2;
+      if (k < capacity && !scanned[b]){
+        scanned[b] = 1;
+        score += score_of[b];
+      }
+    }
+  }
+  out.expect_end();
+  cout << score << endl;
+}
@@ -0,0 +1,50 @@
+// scorer for the pizza warm-up: slices inside the pizza, at least L cells of
+// each ingredient and at most H cells per slice, no overlaps. score = cells
+// covered by slices
+
+#include <iostream>
+#include <vector>
+
+#include "score.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]){
+  if (argc < 3) usage(argv[0]);
+  fast_reader in(argv[1]);
+  ll R, C, L, H;
+  in >> R >> C >> L >> H;
+  // 2d prefix sums of mushrooms, (R + 1) x (C + 1)
+  vector<int> mushrooms((R + 1) * (C + 1), 0);
+  for (ll r = 0; r < R; r++){
+    token row = in.next_token();
+    for (ll c = 0; c < C; c++){
+      int m = c < (ll) row.size && row.data[c] == 'M';
+      mushrooms[(r + 1) * (C + 1) + c + 1] = m + mushrooms[r * (C + 1) + c + 1]
+        + mushrooms[(r + 1) * (C + 1) + c] - mushrooms[r * (C + 1) + c];
+    }
+  }
+
+  checked_reader out(argv[2]);
+  ll S = out.integer("number of slices", 0, R * C);
+  vector<char> used(R * C, 0);
+  ll score = 0;
+  for (ll s = 0; s < S; s++){
+    ll r1 = out.integer("row", 0, R - 1), c1 = out.integer("column", 0, C - 1);
+    ll r2 = out.integer("row", 0, R - 1), c2 = out.integer("column", 0, C - 1);
+    if (r1 > r2) swap(r1, r2);
+    if (c1 > c2) swap(c1, c2);
+    ll area = (r2 - r1 + 1) * (c2 - c1 + 1);
+    ll m = mushrooms[(r2 + 1) * (C + 1) + c2 + 1] - mushrooms[r1 * (C + 1) + c2 + 1]
+      - mushrooms[(r2 + 1) * (C + 1) + c1] + mushrooms[r1 * (C + 1) + c1];
+    if (area > H) out.fail("slice %lld has %lld cells, at most %lld are allowed", s, area, H);
+    if (m < L || area - m < L) out.fail("slice %lld has %lld mushrooms and %lld tomatoes, at least %lld of each are needed", s, m, area - m, L);
+    for (ll r = r1; r <= r2; r++) for (ll c = c1; c <= c2; c++){
+      if (used[r * C + c]) out.fail("slice %lld overlaps cell (%lld, %lld) of another slice", s, r, c);
+      used[r * C + c] = 1;
+    }
+    score += area;
+  }
+  out.expect_end();
+  cout << score << endl;
+}
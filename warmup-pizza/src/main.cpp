@@ -2,12 +2,17 @@
   This file contains the source code for Google Hash Codes Pizza Exercise.
   It uses a divide-and-conquer approach. To this end, the whole area (R x C) is
   divided into smaller areas of size (split x split). Then for each small area
-  all possible pizza cuts are determined and stored as vertices. For each pair
+  all possible pizza cuts are determined and stored as vertices; a cut may also
+  use the cells left over by the areas above and to the left of it, so the
+  areas are solved in anti-diagonal wavefronts on all cores. For each pair
   of vertices (i.e., pizza cuts) it is determined if they overlap. If so, an
-  edge is added between them. For this graph of vertices and edges a mixed-
-  integer program via Gurobi is run with the objective of maximizing the area
-  of the chosen vertices (pizza cuts). All pizza cuts are then added and the
-  next area is considered.
+  edge is added between them. For this graph of vertices and edges a maximum
+  weight independent set is determined exactly with the objective of
+  maximizing the area of the chosen vertices (pizza cuts): every connected
+  component is solved by a broken-profile dynamic program if it is narrow and
+  by branch-and-bound otherwise. All pizza cuts are then added and the next
+  area is considered. Finally, windows across the area borders that still
+  contain uncovered cells are solved again in the same way.
 
   Usage:  - compile with make
           - "./solve <instance name, e.g., medium> ""
@@ -17,14 +22,24 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
 
-#include "gurobi_c++.h"
+#include "../../common/fast_reader.h"
+#include "../../common/fast_writer.h"
+#include "../../common/instance_cache.h"
+#include "../../common/run_control.h"
 
 using namespace std;
 
 typedef pair<int, int> pi;
 
 int split = 10; // size of divide-and-conquer squares. 15 is still okay in speed
+int dp_width = 4; // components at most this narrow are solved by the profile dp
+int lns_window = 14; // side of the windows re-solved after the tiles
+int lns_rounds = 2; // passes over the pizza with shifted windows
+double time_limit = 0; // wall-clock budget in seconds, 0 = none
 
 class vertex{
   // each possible pizza cut is stored in a vertex
@@ -42,27 +57,330 @@ public:
 };
 
 
+class tile_solver{
+  // exact maximum weight independent set of the pizza cuts of one connected component
+public:
+  tile_solver(vector<vertex> &the_vertices, vector<int> &the_adj_begin, vector<int> &the_adj, vector<int> &the_comp){
+    vertices = &the_vertices; adj_begin = &the_adj_begin; adj = &the_adj; comp = the_comp;
+    sort(comp.begin(), comp.end(), [&](int a, int b){
+      vertex &v1 = (*vertices)[a], &v2 = (*vertices)[b];
+      if (v1.get_cost() != v2.get_cost()) return v1.get_cost() > v2.get_cost();
+      if (v1.r != v2.r) return v1.r < v2.r;
+      return v1.c < v2.c;
+    });
+    r0 = c0 = 1 << 30; int r1 = 0, c1 = 0;
+    longest = 0;
+    for (int v: comp){
+      vertex &x = (*vertices)[v];
+      longest = max(longest, max(x.shape.first, x.shape.second));
+      r0 = min(r0, x.r); c0 = min(c0, x.c);
+      r1 = max(r1, x.r + x.shape.first); c1 = max(c1, x.c + x.shape.second);
+    }
+    h = r1 - r0; w = c1 - c0;
+  }
+
+  int solve(vector<int> &indices){
+    // returns the optimal area and appends the chosen vertices to indices
+    vector<int> chosen;
+    int value = (min(h, w) <= dp_width && longest < 16) ? solve_dp(chosen) : solve_bnb(chosen);
+    for (int v: chosen) indices.push_back(v);
+    return value;
+  }
+
+  int solve_dp(vector<int> &chosen){
+    // broken-profile dp over the cells of the bounding box, the profile runs along the shorter side.
+    // it stores for every column how many more rows it stays covered (4 bits each)
+    bool transpose = w > h;
+    int lines = transpose ? w : h, width = transpose ? h : w;
+    auto cut = [&](int v, int &i, int &j, int &a, int &b){
+      vertex &x = (*vertices)[v];
+      i = x.r - r0; j = x.c - c0; a = x.shape.first; b = x.shape.second;
+      if (transpose){ swap(i, j); swap(a, b); }
+    };
+    vector<vector<int> > starting(lines * width); // cuts by top left cell
+    for (int v: comp){
+      int i, j, a, b;
+      cut(v, i, j, a, b);
+      starting[i * width + j].push_back(v);
+    }
+
+    struct entry{
+      uint64_t profile;
+      int value, back, choice;
+    };
+    vector<vector<entry> > layers(lines * width + 1);
+    layers[0].push_back({0, 0, -1, -1});
+    unordered_map<uint64_t, int> index;
+    for (int cell = 0; cell < lines * width; cell++){
+      int j = cell % width;
+      vector<entry> &cur = layers[cell], &next = layers[cell + 1];
+      index.clear();
+      auto relax = [&](uint64_t p, int value, int back, int choice){
+        auto it = index.find(p);
+        if (it == index.end()){
+          index[p] = next.size();
+          next.push_back({p, value, back, choice});
+        }
+        else if (next[it->second].value < value) next[it->second] = {p, value, back, choice};
+      };
+      for (int k = 0; k < (int) cur.size(); k++){
+        uint64_t p = cur[k].profile;
+        int occ = (p >> (4 * j)) & 15;
+        if (occ > 0){
+          // covered from above or from the left
+          relax(p - (uint64_t(1) << (4 * j)), cur[k].value, k, -1);
+          continue;
+        }
+        relax(p, cur[k].value, k, -1);
+        for (int v: starting[cell]){
+          int i0, j0, a, b;
+          cut(v, i0, j0, a, b);
+          bool fits = true;
+          for (int d = j; d < j + b; d++) if ((p >> (4 * d)) & 15) fits = false;
+          if (!fits) continue;
+          uint64_t q = p | (uint64_t(a - 1) << (4 * j));
+          for (int d = j + 1; d < j + b; d++) q |= uint64_t(a) << (4 * d);
+          relax(q, cur[k].value + a * b, k, v);
+        }
+      }
+    }
+
+    vector<entry> &last = layers[lines * width];
+    int best = 0;
+    for (int k = 1; k < (int) last.size(); k++) if (last[k].value > last[best].value) best = k;
+    int value = last[best].value;
+    for (int cell = lines * width; cell > 0; cell--){
+      entry &e = layers[cell][best];
+      if (e.choice >= 0) chosen.push_back(e.choice);
+      best = e.back;
+    }
+    return value;
+  }
+
+  int solve_bnb(vector<int> &chosen){
+    // branch-and-bound on the undecided cell with the fewest cuts left: it is covered by one of them or
+    // stays empty. the bound is the number of cells that are covered or can still be covered
+    int n = comp.size();
+    local.assign(vertices->size(), -1);
+    for (int k = 0; k < n; k++) local[comp[k]] = k;
+    count.assign(h * w, 0);
+    for (int v: comp){
+      vertex &x = (*vertices)[v];
+      for (int i = x.r; i < x.r + x.shape.first; i++){
+        for (int j = x.c; j < x.c + x.shape.second; j++) count[(i - r0) * w + j - c0]++;
+      }
+    }
+    cell_begin.assign(h * w + 1, 0);
+    for (int cell = 0; cell < h * w; cell++) cell_begin[cell + 1] = cell_begin[cell] + count[cell];
+    cell_cuts.resize(cell_begin[h * w]);
+    vector<int> fill(cell_begin.begin(), cell_begin.end() - 1);
+    for (int k = 0; k < n; k++){ // larger cuts are tried first
+      vertex &x = (*vertices)[comp[k]];
+      for (int i = x.r; i < x.r + x.shape.first; i++){
+        for (int j = x.c; j < x.c + x.shape.second; j++) cell_cuts[fill[(i - r0) * w + j - c0]++] = k;
+      }
+    }
+    total = 0;
+    for (int cell = 0; cell < h * w; cell++) if (count[cell] > 0) total++;
+    covered.assign(h * w, false);
+    empty.assign(h * w, false);
+    alive.assign(n, true);
+    lost = 0; value = 0; best_value = -1;
+    dfs();
+    for (int k: best_set) chosen.push_back(comp[k]);
+    return best_value;
+  }
+
+private:
+  void kill(int k){
+    // cut k can no longer be taken
+    alive[k] = false;
+    killed.push_back(k);
+    vertex &x = (*vertices)[comp[k]];
+    for (int i = x.r; i < x.r + x.shape.first; i++){
+      for (int j = x.c; j < x.c + x.shape.second; j++){
+        int cell = (i - r0) * w + j - c0;
+        if (--count[cell] == 0 && !covered[cell] && !empty[cell]) lost++;
+      }
+    }
+  }
+
+  void revive(int until){
+    while ((int) killed.size() > until){
+      int k = killed.back(); killed.pop_back();
+      alive[k] = true;
+      vertex &x = (*vertices)[comp[k]];
+      for (int i = x.r; i < x.r + x.shape.first; i++){
+        for (int j = x.c; j < x.c + x.shape.second; j++){
+          int cell = (i - r0) * w + j - c0;
+          if (count[cell]++ == 0 && !covered[cell] && !empty[cell]) lost--;
+        }
+      }
+    }
+  }
+
+  void set_covered(int k, bool b){
+    vertex &x = (*vertices)[comp[k]];
+    for (int i = x.r; i < x.r + x.shape.first; i++){
+      for (int j = x.c; j < x.c + x.shape.second; j++) covered[(i - r0) * w + j - c0] = b;
+    }
+  }
+
+  bool dominated(){
+    // the rest of the search only depends on which cells are decided (covered or empty).
+    // if these were reached before with at least the same value, nothing better can be found here
+    string key((h * w + 7) / 8, 0);
+    for (int cell = 0; cell < h * w; cell++){
+      if (covered[cell] || empty[cell]) key[cell >> 3] |= 1 << (cell & 7);
+    }
+    auto it = seen.find(key);
+    if (it != seen.end() && it->second >= value) return true;
+    if (seen.size() >= max_seen) seen.clear();
+    seen[key] = value;
+    return false;
+  }
+
+  void dfs(){
+    if (run_control::stopped()){
+      // out of time: the cuts taken so far do not overlap, keep them if they beat the incumbent
+      if (value > best_value){
+        best_value = value;
+        best_set = taken;
+      }
+      return;
+    }
+    if (total - lost <= best_value) return;
+    int cell = -1;
+    for (int c = 0; c < h * w; c++){
+      if (covered[c] || empty[c] || count[c] == 0) continue;
+      if (cell < 0 || count[c] < count[cell]) cell = c;
+    }
+    if (cell < 0){
+      // every cell is covered or lost
+      best_value = value;
+      best_set = taken;
+      return;
+    }
+    if (dominated()) return;
+    int mark = killed.size();
+    for (int e = cell_begin[cell]; e < cell_begin[cell + 1]; e++){
+      int t = cell_cuts[e];
+      if (!alive[t]) continue;
+      // take cut t: its cells are covered and all overlapping cuts die
+      set_covered(t, true);
+      value += (*vertices)[comp[t]].get_cost();
+      taken.push_back(t);
+      kill(t);
+      int v = comp[t];
+      for (int k = (*adj_begin)[v]; k < (*adj_begin)[v + 1]; k++){
+        int u = local[(*adj)[k]];
+        if (alive[u]) kill(u);
+      }
+      dfs();
+      revive(mark);
+      taken.pop_back();
+      value -= (*vertices)[comp[t]].get_cost();
+      set_covered(t, false);
+      if (total - lost <= best_value) return;
+    }
+    // leave the cell empty
+    empty[cell] = true;
+    lost++;
+    for (int e = cell_begin[cell]; e < cell_begin[cell + 1]; e++){
+      if (alive[cell_cuts[e]]) kill(cell_cuts[e]);
+    }
+    dfs();
+    revive(mark);
+    lost--;
+    empty[cell] = false;
+  }
+
+  vector<vertex> *vertices;
+  vector<int> *adj_begin, *adj;
+  vector<int> comp; // vertices of the component, larger cuts first
+  int r0, c0, h, w; // bounding box of the component
+  int longest; // longest side of a cut
+
+  // branch-and-bound state
+  vector<int> local; // vertex -> position in comp
+  vector<int> cell_begin, cell_cuts; // cuts covering each cell
+  vector<int> count; // alive cuts per cell
+  vector<bool> covered, empty; // decided cells
+  vector<bool> alive;
+  vector<int> killed, taken, best_set;
+  int total, lost, value, best_value;
+  unordered_map<string, int> seen; // decided cells -> best value reaching them
+  const size_t max_seen = 1 << 20;
+};
+
+
 class instance{
 public:
-    void read(){
+    void read(fast_reader &in){
       // reads data
-      cin >> R >> C >> min_items >> max_cells;
+      in >> R >> C >> min_items >> max_cells;
       pizza.resize(R);
       for (int r = 0; r < R; r++) pizza[r].resize(C);
-      used = pizza;
-      char cr;
+      for (int r = 0; r < R; r++){
+        token row = in.next_token();
+        for (int c = 0; c < C && c < (int) row.size; c++) if (row.data[c] == 'M') pizza[r][c] = 1;
+      }
+      // prefix sums of mushrooms and an empty bitboard of used cells
+      mushrooms.assign((R + 1) * (C + 1), 0);
       for (int r = 0; r < R; r++) for (int c = 0; c < C; c++){
-        cin >> cr;
-        if (cr == 'M') pizza[r][c] = 1;
+        mushrooms[(r + 1) * (C + 1) + c + 1] = pizza[r][c] + mushrooms[r * (C + 1) + c + 1]
+          + mushrooms[(r + 1) * (C + 1) + c] - mushrooms[r * (C + 1) + c];
+      }
+      words = C / 64 + 1;
+      used.assign(R * words, 0);
+    }
+
+    // instance cache: the prefix sums are stored, the grid is recovered from them
+    void save(cache_writer &snapshot){
+      int header[4] = {R, C, min_items, max_cells};
+      snapshot.put(header, 4);
+      snapshot.put(mushrooms);
+    }
+
+    void load(cache_reader &snapshot){
+      size_t n;
+      const int *header = snapshot.view<int>(n);
+      R = header[0]; C = header[1]; min_items = header[2]; max_cells = header[3];
+      snapshot.get(mushrooms);
+      pizza.assign(R, vector<bool>(C));
+      for (int r = 0; r < R; r++) for (int c = 0; c < C; c++) pizza[r][c] = count_mushrooms(r, c, r + 1, c + 1);
+      words = C / 64 + 1;
+      used.assign(R * words, 0);
+    }
+
+    int count_mushrooms(int r1, int c1, int r2, int c2){
+      // mushrooms in [r1, r2) x [c1, c2)
+      return mushrooms[r2 * (C + 1) + c2] - mushrooms[r1 * (C + 1) + c2]
+        - mushrooms[r2 * (C + 1) + c1] + mushrooms[r1 * (C + 1) + c1];
+    }
+
+    // areas solved at the same time share words of used, hence the atomic accesses
+    bool is_used(int r, int c){
+      return (__atomic_load_n(&used[r * words + (c >> 6)], __ATOMIC_RELAXED) >> (c & 63)) & 1;
+    }
+
+    bool row_free(int r, int c, int w){
+      // true if none of the cells (r, c) .. (r, c + w - 1) is used
+      uint64_t* row = used.data() + r * words;
+      for (int k = c; k < c + w; k = (k | 63) + 1){
+        int n = min(c + w - k, 64 - (k & 63));
+        uint64_t mask = (n == 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1) << (k & 63);
+        if (__atomic_load_n(&row[k >> 6], __ATOMIC_RELAXED) & mask) return false;
       }
+      return true;
     }
 
-    void write_output(){
+    void write_output(fast_writer &os){
       // writes output
-      cout << out.size() << endl;
+      os << out.size() << '\n';
       for (auto o: out){
-        for (int i: o) cout << i << " ";
-        cout << endl;
+        for (int i: o) os << i << ' ';
+        os << '\n';
       }
     }
 
@@ -75,36 +393,26 @@ public:
       }
     }
 
-    bool overlap(vertex &v1, vertex &v2){
-      if (v1.r == v2.r && v1.c == v2.c) return false;
-      if (v2.r >= v1.r + v1.shape.first || v2.c >= v1.c + v1.shape.second ) return true;
-      if (v1.r >= v2.r + v2.shape.first  || v1.c >= v2.c + v2.shape.second ) return true;
-      return false;
-    }
-
     bool check_area(int i, int j, pi &f, int r, int c){
       // checks if some area of the curent candidate has already been used
       if (!(i + f.first <= r && j + f.second <= c)) return false;
-      int tcount = 0;
+      int mcount = count_mushrooms(i, j, i + f.first, j + f.second);
+      int tcount = f.first * f.second - mcount;
+      if ((tcount < min_items) || (mcount < min_items)) return false;
       for (int d1 = i; d1 < i + f.first; d1++){
-        for (int d2 = j; d2 < j + f.second; d2++){
-          if (used[d1][d2]) return false;
-          if (!pizza[d1][d2]) tcount++;
-        }
+        if (!row_free(d1, j, f.second)) return false;
       }
-      if ((tcount < min_items) || (f.first * f.second - tcount < min_items)) return false;
       return true;
     }
 
-    void get_vertices(vector<vertex> &vertices, int r, int c){
-      // determines all vertices, i.e. all possible pizza cuts in the specified area.
+    void get_vertices(vector<vertex> &vertices, int r1, int c1, int r2, int c2){
+      // determines all vertices, i.e. all possible pizza cuts in the area [r1, r2) x [c1, c2).
       // hence all (top left) starting positions (r,c) are iterated and all possible shapes are tested
-      r = min(r, R); c = min(c, C);
-      for (int i = 0; i < r; i++){
-        for (int j = 0; j < c; j++){
-          if (used[i][j]) continue;
+      for (int i = r1; i < r2; i++){
+        for (int j = c1; j < c2; j++){
+          if (is_used(i, j)) continue;
           for (auto f: shapes){
-            if (!check_area(i, j, f, r, c)) continue;
+            if (!check_area(i, j, f, r2, c2)) continue;
             else {
               vertex v = vertex(i, j, f);
               vertices.push_back(v);
@@ -114,69 +422,120 @@ public:
       }
     }
 
-    void get_edges(vector<pi> &edges, vector<vertex> &vertices){
-      // determines all edges. between the vertices. an edge is added if two pizza cuts (i.e. vertices) overlap
+    void get_edges(vector<int> &adj_begin, vector<int> &adj, vector<vertex> &vertices, int r1, int c1, int r2, int c2){
+      // determines all edges between the vertices. an edge is added if two pizza cuts (i.e. vertices) overlap.
+      // instead of testing all pairs, every cell keeps the list of cuts covering it and two cuts are
+      // paired at the top left cell of their intersection only, so each edge is found exactly once.
+      // the result is stored as adjacency lists: neighbours of i are adj[adj_begin[i] .. adj_begin[i + 1])
+      int r = r2 - r1, c = c2 - c1;
       int n = vertices.size();
-      for (int v1 = 0; v1 < n; v1++){
-        for (int v2 = 0; v2 < v1; v2++){
-          if (!overlap(vertices[v1], vertices[v2])) edges.push_back({v1, v2});
+      vector<int> cell_begin(r * c + 1, 0), cell;
+      for (auto &v: vertices){
+        for (int i = v.r; i < v.r + v.shape.first; i++){
+          for (int j = v.c; j < v.c + v.shape.second; j++) cell_begin[(i - r1) * c + j - c1 + 1]++;
         }
       }
+      for (int i = 0; i < r * c; i++) cell_begin[i + 1] += cell_begin[i];
+      cell.resize(cell_begin[r * c]);
+      vector<int> fill(cell_begin.begin(), cell_begin.end() - 1);
+      for (int k = 0; k < n; k++){
+        vertex &v = vertices[k];
+        for (int i = v.r; i < v.r + v.shape.first; i++){
+          for (int j = v.c; j < v.c + v.shape.second; j++) cell[fill[(i - r1) * c + j - c1]++] = k;
+        }
+      }
+
+      vector<pi> edges;
+      for (int i = 0; i < r; i++){
+        for (int j = 0; j < c; j++){
+          int lo = cell_begin[i * c + j], hi = cell_begin[i * c + j + 1];
+          for (int a = lo; a < hi; a++){
+            vertex &v1 = vertices[cell[a]];
+            for (int b = lo; b < a; b++){
+              vertex &v2 = vertices[cell[b]];
+              if (max(v1.r, v2.r) == r1 + i && max(v1.c, v2.c) == c1 + j) edges.push_back({cell[a], cell[b]});
+            }
+          }
+        }
+      }
+
+      adj_begin.assign(n + 1, 0);
+      for (auto &e: edges){
+        adj_begin[e.first + 1]++;
+        adj_begin[e.second + 1]++;
+      }
+      for (int i = 0; i < n; i++) adj_begin[i + 1] += adj_begin[i];
+      adj.resize(adj_begin[n]);
+      fill.assign(adj_begin.begin(), adj_begin.end() - 1);
+      for (auto &e: edges){
+        adj[fill[e.first]++] = e.second;
+        adj[fill[e.second]++] = e.first;
+      }
     }
 
-    void max_independent_set(vector<vertex> &vertices, vector<pi> &edges, vector<int> &indices){
-      // sets up a mixed integer program to solve maximal independent set problem
+    int max_independent_set(vector<vertex> &vertices, vector<int> &adj_begin, vector<int> &adj, vector<int> &indices){
+      // solves the maximum weight independent set problem exactly, one connected component at a time.
+      // returns the covered area
       int v = vertices.size();
-      int e = edges.size();
-      GRBEnv env;
-      GRBModel m = GRBModel(env);
-      m.getEnv().set("OutputFlag", "0");
-      vector<GRBVar> x(v); // x[i] = 1 <=> vertex i is chosen
-      for (long long i = 0; i < v; i++) x[i] = m.addVar(0, 1, 1,GRB_BINARY);
-      m.update();
-      for (int i = 0; i < e; i++){
-        m.addConstr(x[edges[i].first] + x[edges[i].second] <= 1);
-      }
-      m.update();
-      GRBLinExpr objective_function = 0;
-      for (long long i = 0; i < v; i++){
-          objective_function += vertices[i].get_cost() * x[i];
-      }
-      m.setObjective(objective_function, GRB_MAXIMIZE);
-      m.optimize();
-
-      for (long long i = 0; i < v; i++){
-          if (x[i].get(GRB_DoubleAttr_X) > 0.5){
-            indices.push_back(i);
+      vector<int> comp_of(v, -1), comp, stack;
+      int objective = 0;
+      for (int s = 0; s < v; s++){
+        if (comp_of[s] >= 0) continue;
+        comp.clear();
+        stack.push_back(s);
+        comp_of[s] = s;
+        while (!stack.empty()){
+          int x = stack.back(); stack.pop_back();
+          comp.push_back(x);
+          for (int k = adj_begin[x]; k < adj_begin[x + 1]; k++){
+            if (comp_of[adj[k]] < 0){
+              comp_of[adj[k]] = s;
+              stack.push_back(adj[k]);
+            }
           }
+        }
+        tile_solver ts(vertices, adj_begin, adj, comp);
+        objective += ts.solve(indices);
       }
-      cout << m.get(GRB_DoubleAttr_ObjVal) << endl;
-
+      return objective;
     }
+
     void cover_area(vertex &v){
       // this area is already subject to some pizza cut
       for (int i = v.r; i < v.r + v.shape.first; i++){
         for (int j = v.c; j < v.c + v.shape.second; j++){
-          used[i][j] = true;
+          __atomic_fetch_or(&used[i * words + (j >> 6)], uint64_t(1) << (j & 63), __ATOMIC_RELAXED);
         }
       }
     }
 
-    void solve_area(int r, int c){
-      // for each considered area at position (r,c) to (r+split, c+split) we determine pizza cuts
+    void release_area(vector<int> &o){
+      // the cut o (in output format) is undone
+      for (int i = o[0]; i <= o[2]; i++){
+        for (int j = o[1]; j <= o[3]; j++){
+          __atomic_fetch_and(&used[i * words + (j >> 6)], ~(uint64_t(1) << (j & 63)), __ATOMIC_RELAXED);
+        }
+      }
+    }
+
+    int solve_area(int ti, int tj, vector<vector<int> > &cuts){
+      // for the area of tile (ti, tj) we determine pizza cuts. they may also use the cells left over by
+      // the tiles above, to the left and above left, so only these four tiles are read or written.
       // first all vertices = possible pizza cuts are determined and then a maximal independend set problem is solved
+      int r1 = max(0, ti - 1) * split, c1 = max(0, tj - 1) * split;
+      int r2 = min(R, (ti + 1) * split), c2 = min(C, (tj + 1) * split);
       vector<vertex> vertices;
-      vector<pi> edges;
-      get_vertices(vertices, r, c);
+      vector<int> adj_begin, adj; // conflict graph
+      get_vertices(vertices, r1, c1, r2, c2);
       vector<int> indices; // index set of all vertices (pizza cuts) that shall be executed
-      get_edges(edges, vertices);
-      max_independent_set(vertices, edges, indices);
+      get_edges(adj_begin, adj, vertices, r1, c1, r2, c2);
+      int area = max_independent_set(vertices, adj_begin, adj, indices);
       for (int i: indices){
         cover_area(vertices[i]);
         vertex &v = vertices[i];
-        score += v.get_cost();
-        out.push_back({v.r, v.c, v.r + v.shape.first - 1, v.c + v.shape.second - 1});
+        cuts.push_back({v.r, v.c, v.r + v.shape.first - 1, v.c + v.shape.second - 1});
       }
+      return area;
     }
 
     void solve(){
@@ -185,33 +544,141 @@ public:
 
       cerr << "square size: " << split << " x " <<  split << endl;
       // solve by divide-and-conquer:
-      // start cutting from top left to bottom right..
-      for (int r = split; r <= max(split, R); r += split){
-        for (int c = split; c <= max(split, C); c += split){
-          cout << r << " x " << c << endl;
-          solve_area(r, c);
+      // start cutting from top left to bottom right. tile (i, j) needs the tiles (i - 1, j) and (i, j - 1),
+      // so all tiles of an anti-diagonal can be solved once the previous one is done. two tiles of the same
+      // diagonal that are one row apart share a neighbour, hence even and odd rows take turns
+      int nr = (R + split - 1) / split, nc = (C + split - 1) / split;
+      vector<vector<vector<int> > > tile_cuts(nr * nc);
+      // tiles left out when the run is stopped simply stay uncut
+      for (int d = 0; d < nr + nc - 1 && !run_control::stopped(); d++){
+        for (int parity = 0; parity < 2; parity++){
+          vector<int> rows;
+          for (int i = max(0, d - nc + 1); i <= min(d, nr - 1); i++) if (i % 2 == parity) rows.push_back(i);
+          int area = 0;
+          #pragma omp parallel for schedule(dynamic) reduction(+:area)
+          for (int k = 0; k < (int) rows.size(); k++){
+            int i = rows[k], j = d - rows[k];
+            area += solve_area(i, j, tile_cuts[i * nc + j]);
+          }
+          score += area;
         }
-        solve_area(r, C);
+        cerr << "wavefront " << d + 1 << " / " << nr + nc - 1 << endl;
       }
-      for (int c = split; c <= max(split, C); c += split) solve_area(R, c);
-      solve_area(R, C);
+      for (auto &cuts: tile_cuts) for (auto &o: cuts) out.push_back(o);
       cerr << "score: " << score << endl;
     }
 
+    int resolve_window(int r1, int c1, int r2, int c2, vector<int> &released, vector<vector<int> > &cuts){
+      // releases all cuts inside [r1, r2) x [c1, c2) and solves the window again, cuts crossing its
+      // border stay. returns the gained area; if there is none the old cuts are restored
+      int old_area = 0;
+      for (int i = r1; i < r2; i++){
+        for (int j = c1; j < c2; j++){
+          int k = owner[i * C + j];
+          if (k < 0) continue;
+          vector<int> &o = out[k];
+          if (o[0] != i || o[1] != j || o[2] >= r2 || o[3] >= c2) continue;
+          released.push_back(k);
+          old_area += (o[2] - o[0] + 1) * (o[3] - o[1] + 1);
+          release_area(o);
+        }
+      }
+      vector<vertex> vertices;
+      vector<int> adj_begin, adj;
+      get_vertices(vertices, r1, c1, r2, c2);
+      get_edges(adj_begin, adj, vertices, r1, c1, r2, c2);
+      vector<int> indices;
+      int area = max_independent_set(vertices, adj_begin, adj, indices);
+      if (area <= old_area){
+        for (int k: released) cover_area_of(out[k]);
+        released.clear();
+        return 0;
+      }
+      for (int i: indices){
+        vertex &v = vertices[i];
+        cover_area(v);
+        cuts.push_back({v.r, v.c, v.r + v.shape.first - 1, v.c + v.shape.second - 1});
+      }
+      return area - old_area;
+    }
+
+    void cover_area_of(vector<int> &o){
+      vertex v(o[0], o[1], {o[2] - o[0] + 1, o[3] - o[1] + 1});
+      cover_area(v);
+    }
+
+    void set_owner(vector<int> &o, int k){
+      for (int i = o[0]; i <= o[2]; i++) for (int j = o[1]; j <= o[3]; j++) owner[i * C + j] = k;
+    }
+
+    void improve(){
+      // large neighbourhood search after the tiles: the pizza is split into windows of lns_window x lns_window
+      // cells, shifted every round so that they straddle the tile borders. every window with an uncovered
+      // cell is re-solved; the windows of a round do not overlap, so they run in parallel
+      owner.assign(R * C, -1);
+      for (int k = 0; k < (int) out.size(); k++) set_owner(out[k], k);
+      auto bands = [](int n, int off){
+        vector<pi> b;
+        if (off > 0) b.push_back({0, min(n, off)});
+        for (int x = off; x < n; x += lns_window) b.push_back({x, min(n, x + lns_window)});
+        return b;
+      };
+      for (int round = 0; round < lns_rounds && !run_control::stopped(); round++){
+        int off = (split / 2 + round * lns_window / lns_rounds) % lns_window;
+        vector<pi> rows = bands(R, off), cols = bands(C, off);
+        vector<pair<pi, pi> > windows;
+        for (auto &rb: rows) for (auto &cb: cols){
+          bool open = false;
+          for (int i = rb.first; i < rb.second; i++){
+            for (int j = cb.first; j < cb.second; j++) if (!is_used(i, j)) open = true;
+          }
+          if (open) windows.push_back({rb, cb});
+        }
+        int n = windows.size();
+        vector<vector<int> > released(n);
+        vector<vector<vector<int> > > cuts(n);
+        int gain = 0;
+        #pragma omp parallel for schedule(dynamic) reduction(+:gain)
+        for (int k = 0; k < n; k++){
+          pi rb = windows[k].first, cb = windows[k].second;
+          gain += resolve_window(rb.first, cb.first, rb.second, cb.second, released[k], cuts[k]);
+        }
+        for (int k = 0; k < n; k++){
+          for (int c: released[k]){
+            set_owner(out[c], -1);
+            out[c].clear();
+          }
+          for (auto &o: cuts[k]){
+            set_owner(o, out.size());
+            out.push_back(o);
+          }
+        }
+        score += gain;
+        cerr << "lns round " << round + 1 << ": " << n << " windows, score " << score << endl;
+      }
+      vector<vector<int> > kept;
+      for (auto &o: out) if (!o.empty()) kept.push_back(o);
+      out.swap(kept);
+    }
+
     // instance variables
     int C, R;
     int min_items, max_cells;
     vector<vector<bool> > pizza; // 0 = tomato, 1 = mushroom
-    vector<vector<bool> > used; // area that was already cut
+    vector<int> mushrooms; // 2d prefix sums of pizza, (R + 1) x (C + 1)
+    int words; // 64 bit words per row of used
+    vector<uint64_t> used; // area that was already cut, one bit per cell
 
     vector<pair<int, int> > shapes; // all possible shapes
     int score = 0; // current score
     vector<vector<int> > out; // all done cuts stored in output format
+    vector<int> owner; // index in out of the cut covering each cell, -1 if uncovered
 };
 
 int main(int argc, char** argv){
   ios::sync_with_stdio(false);
   cin.tie(0);
+  run_control::start(time_limit);
 
   instance I;
 
@@ -220,14 +687,14 @@ int main(int argc, char** argv){
   if (argc < 2) filename = "example";
   else filename = argv[1];
   string input_file = "../data/" + filename + ".in";
-  freopen(input_file.c_str(), "r", stdin);
-  I.read();
+  read_instance(I, input_file, "warmup-pizza", 1);
 
   // solve instance
   I.solve();
+  I.improve();
 
   // file output
   string output_file = "../out/" + filename + ".out";
-  freopen(output_file.c_str(), "w", stdout);
-  I.write_output();
+  fast_writer os(output_file.c_str());
+  I.write_output(os);
 }